@@ -0,0 +1,1054 @@
+// ReSharper disable CppUnusedIncludeDirective
+#include "src/SparseMatrix.hpp"
+#include "src/CsrMatrix.hpp"
+#include "src/BsrMatrix.hpp"
+#include "src/CsrFile.hpp"
+#include "src/SmallMatrix.hpp"
+#include "src/HybridMatrix.hpp"
+#include "src/Dijkstra.h"
+#include "src/Kruskal.h"
+#include "src/ContractionHierarchy.h"
+#include "src/AllPairs.hpp"
+#include "src/DynamicSssp.h"
+#include "main.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <tuple>
+#include <vector>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
+/**
+ * \brief 计时，返回单次调用的平均纳秒数
+ * \tparam F 被测函数类型
+ * \param reps 重复次数
+ * \param f 被测函数
+ * \return 平均纳秒数
+ */
+template <typename F>
+double bench_ns(size_t reps, F&& f)
+{
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i != reps; ++i) {
+		f();
+	}
+	auto t1 = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+}
+
+/**
+ * \brief 输出一行CSV结果
+ * \param name 测试名
+ * \param metric 指标名
+ * \param value 指标值
+ */
+void bench_report(const char* name, const char* metric, double value)
+{
+	std::cout << name << "," << metric << "," << value << std::endl;
+}
+
+/**
+ * \brief 将峰值常驻内存重置为当前常驻内存
+ * \details Linux下向/proc/self/clear_refs写入5以重置VmHWM，其他平台不做任何事
+ */
+void bench_reset_peak_rss()
+{
+#ifdef __linux__
+	if (auto f = std::fopen("/proc/self/clear_refs", "w")) {
+		std::fputs("5", f);
+		std::fclose(f);
+	}
+#endif
+}
+
+/**
+ * \brief 进程的峰值常驻内存
+ * \details Linux下读取/proc/self/status中的VmHWM，为上次bench_reset_peak_rss以来的峰值；其他平台为进程启动以来的峰值
+ * \return 峰值常驻内存(KB)，不支持的平台返回0
+ */
+long bench_peak_rss_kb()
+{
+#ifdef _WIN32
+	return 0;
+#else
+#ifdef __linux__
+	if (auto f = std::fopen("/proc/self/status", "r")) {
+		char line[256];
+		long kb = -1;
+		while (kb < 0 && std::fgets(line, sizeof(line), f)) {
+			std::sscanf(line, "VmHWM: %ld kB", &kb);
+		}
+		std::fclose(f);
+		if (kb >= 0) {
+			return kb;
+		}
+	}
+#endif
+	rusage ru;
+	getrusage(RUSAGE_SELF, &ru);
+	return ru.ru_maxrss;
+#endif
+}
+
+/**
+ * \brief 三元组形式的矩阵数据
+ */
+struct bench_triplets
+{
+	std::vector<size_t> rows;
+	std::vector<size_t> cols;
+	std::vector<double> vals;
+
+	void add(size_t r, size_t c, double v)
+	{
+		rows.push_back(r);
+		cols.push_back(c);
+		vals.push_back(v);
+	}
+};
+
+/**
+ * \brief 基准矩阵的结构
+ */
+enum class bench_shape
+{
+	Random,
+	Banded,
+	PowerLaw,
+	Block,
+};
+
+const char* bench_shape_name(bench_shape shape)
+{
+	switch (shape) {
+	case bench_shape::Random: return "random";
+	case bench_shape::Banded: return "banded";
+	case bench_shape::PowerLaw: return "powerlaw";
+	case bench_shape::Block: return "block";
+	}
+	return "";
+}
+
+/**
+ * \brief 生成指定结构的随机三元组
+ * \details
+ * Random为均匀分布；Banded为半带宽density / 2的带状矩阵；
+ * PowerLaw的行号按u^3分布，少数行含有大量元素；Block为随机摆放的稠密8x8块
+ * \tparam N 矩阵阶数
+ * \param shape 矩阵结构
+ * \param density 平均每行元素个数
+ * \param g 随机数发生器
+ * \return 三元组，可能含有重复坐标
+ */
+template <size_t N>
+bench_triplets bench_generate(bench_shape shape, size_t density, std::mt19937& g)
+{
+	bench_triplets t;
+	std::uniform_int_distribution<size_t> pos(0, N - 1);
+	std::uniform_real_distribution<double> unit(0.0, 1.0);
+	std::uniform_real_distribution<double> val(-1.0, 1.0);
+	switch (shape) {
+	case bench_shape::Random:
+		for (size_t k = 0; k != N * density; ++k) {
+			t.add(pos(g), pos(g), val(g));
+		}
+		break;
+	case bench_shape::Banded: {
+		auto h = density / 2;
+		for (size_t i = 0; i != N; ++i) {
+			for (auto j = i < h ? 0 : i - h; j != std::min(N, i + h + 1); ++j) {
+				t.add(i, j, val(g));
+			}
+		}
+		break;
+	}
+	case bench_shape::PowerLaw:
+		for (size_t k = 0; k != N * density; ++k) {
+			auto r = std::min(N - 1, static_cast<size_t>(N * std::pow(unit(g), 3.0)));
+			t.add(r, pos(g), val(g));
+		}
+		break;
+	case bench_shape::Block: {
+		const size_t bs = 8;
+		std::uniform_int_distribution<size_t> block(0, N / bs - 1);
+		for (size_t bi = 0; bi != N / bs; ++bi) {
+			for (size_t k = 0; k != std::max<size_t>(1, density / bs); ++k) {
+				auto bj = block(g);
+				for (size_t r = 0; r != bs; ++r) {
+					for (size_t c = 0; c != bs; ++c) {
+						t.add(bi * bs + r, bj * bs + c, val(g));
+					}
+				}
+			}
+		}
+		break;
+	}
+	}
+	return t;
+}
+
+/**
+ * \brief 对一种结构的矩阵测量构造、get、row、Add、Mul与Rev
+ * \details 结果以ns/nnz输出，并附带本次测量期间的峰值常驻内存
+ * \tparam N 矩阵阶数
+ * \param shape 矩阵结构
+ * \param density 平均每行元素个数
+ * \param g 随机数发生器
+ */
+template <size_t N>
+void bench_suite(bench_shape shape, size_t density, std::mt19937& g)
+{
+	using matrix = sparse_matrix2d<double, N, N>;
+	bench_reset_peak_rss();
+	auto name = std::string("suite_") + bench_shape_name(shape) + "_" + std::to_string(N);
+	auto t = bench_generate<N>(shape, density, g);
+	auto t2 = bench_generate<N>(shape, density, g);
+	auto m = matrix::from_triplets(t.rows, t.cols, t.vals);
+	auto m2 = matrix::from_triplets(t2.rows, t2.cols, t2.vals);
+	auto n = static_cast<double>(t.vals.size());
+	auto nnz = static_cast<double>(m.size());
+	auto sink = 0.0;
+
+	bench_report(name.c_str(), "nnz", nnz);
+	bench_report(name.c_str(), "set_ns_per_nnz", bench_ns(1, [&] {
+		auto r = matrix();
+		for (size_t k = 0; k != t.vals.size(); ++k) {
+			r.set(t.vals[k], t.rows[k], t.cols[k]);
+		}
+	}) / n);
+	bench_report(name.c_str(), "from_triplets_ns_per_nnz", bench_ns(1, [&] {
+		matrix::from_triplets(t.rows, t.cols, t.vals);
+	}) / n);
+	bench_report(name.c_str(), "get_ns_per_nnz", bench_ns(1, [&] {
+		for (size_t k = 0; k != t.vals.size(); ++k) {
+			sink += m.get(t.rows[k], t.cols[k]);
+		}
+	}) / n);
+	bench_report(name.c_str(), "row_ns_per_nnz", bench_ns(1, [&] {
+		for (size_t i = 0; i != N; ++i) {
+			sink += m.row(i).size();
+		}
+	}) / nnz);
+	bench_report(name.c_str(), "add_ns_per_nnz", bench_ns(1, [&] { sink += m.Add(m2).size(); }) / (nnz + m2.size()));
+	bench_report(name.c_str(), "mul_ns_per_nnz", bench_ns(1, [&] { sink += m.Mul(m).size(); }) / nnz);
+	bench_report(name.c_str(), "rev_ns_per_nnz", bench_ns(1, [&] { sink += m.Rev().size(); }) / nnz);
+	bench_report(name.c_str(), "peak_rss_kb", static_cast<double>(bench_peak_rss_kb()));
+	if (sink == 42.0) {
+		std::cout << std::endl;
+	}
+}
+
+/**
+ * \brief 对全部结构运行bench_suite
+ * \tparam N 矩阵阶数
+ * \param density 平均每行元素个数
+ * \param g 随机数发生器
+ */
+template <size_t N>
+void bench_suites(size_t density, std::mt19937& g)
+{
+	for (auto shape : { bench_shape::Random, bench_shape::Banded, bench_shape::PowerLaw, bench_shape::Block }) {
+		bench_suite<N>(shape, density, g);
+	}
+}
+
+/**
+ * \brief 生成块结构的随机矩阵，每个块行含有若干稠密BSxBS块
+ * \tparam N 矩阵阶数
+ * \tparam BS 块大小
+ * \param blocks_per_row 每个块行的块数
+ * \param g 随机数发生器
+ * \return 矩阵
+ */
+template <size_t N, size_t BS>
+sparse_matrix2d<double, N, N> bench_block_matrix(size_t blocks_per_row, std::mt19937& g)
+{
+	auto m = sparse_matrix2d<double, N, N>();
+	std::uniform_int_distribution<size_t> col(0, N / BS - 1);
+	std::uniform_real_distribution<double> val(-1.0, 1.0);
+	for (size_t bi = 0; bi != N / BS; ++bi) {
+		for (size_t k = 0; k != blocks_per_row; ++k) {
+			auto bj = col(g);
+			for (size_t r = 0; r != BS; ++r) {
+				for (size_t c = 0; c != BS; ++c) {
+					m.set(val(g), bi * BS + r, bj * BS + c);
+				}
+			}
+		}
+	}
+	return m;
+}
+
+template <size_t N, size_t BS>
+void bench_bsr_vs_csr(const char* spmv_name, const char* spgemm_name, std::mt19937& g)
+{
+	auto m = bench_block_matrix<N, BS>(8, g);
+	auto csr = csr_matrix<double, N, N>(m);
+	auto bsr = bsr_matrix<double, N, N, BS>(m);
+	auto x = std::vector<double>(N, 1.0);
+	auto y = std::vector<double>(N);
+	auto nnz = static_cast<double>(m.size());
+
+	bench_report(spmv_name, "csr_ns_per_nnz", bench_ns(50, [&] { csr.spmv(x.data(), y.data()); }) / nnz);
+	bench_report(spmv_name, "bsr_ns_per_nnz", bench_ns(50, [&] { bsr.spmv(x.data(), y.data()); }) / nnz);
+	bench_report(spgemm_name, "csr_ns_per_nnz", bench_ns(2, [&] { csr.Mul(csr); }) / nnz);
+	bench_report(spgemm_name, "bsr_ns_per_nnz", bench_ns(2, [&] { bsr.Mul(bsr); }) / nnz);
+}
+
+/**
+ * \brief 生成均匀随机稀疏矩阵
+ * \tparam N 矩阵阶数
+ * \param nnz 期望非零元素个数
+ * \param g 随机数发生器
+ * \return 矩阵
+ */
+template <size_t N>
+sparse_matrix2d<double, N, N> bench_random_matrix(size_t nnz, std::mt19937& g)
+{
+	auto m = sparse_matrix2d<double, N, N>();
+	std::uniform_int_distribution<size_t> pos(0, N - 1);
+	std::uniform_real_distribution<double> val(-1.0, 1.0);
+	for (size_t k = 0; k != nnz; ++k) {
+		m.set(val(g), pos(g), pos(g));
+	}
+	return m;
+}
+
+template <size_t N>
+void bench_expression(std::mt19937& g)
+{
+	auto a = bench_random_matrix<N>(N * 16, g);
+	auto b = bench_random_matrix<N>(N * 16, g);
+	auto c = bench_random_matrix<N>(N * 16, g);
+	auto d = bench_random_matrix<N>(N * 16, g);
+	auto nnz = static_cast<double>(a.size() + b.size() + c.size() + d.size());
+
+	bench_report("expr_4term", "eager_ns_per_nnz", bench_ns(5, [&] { a.Add(b).Sub(c).Add(d.Axpby(2.0, d, 0.0)); }) / nnz);
+	bench_report("expr_4term", "lazy_ns_per_nnz", bench_ns(5, [&] { sparse_matrix2d<double, N, N> r = a + b - c + 2.0 * d; }) / nnz);
+}
+
+template <size_t N>
+void bench_construction(size_t nnz, std::mt19937& g)
+{
+	auto rows = std::vector<size_t>(nnz);
+	auto cols = std::vector<size_t>(nnz);
+	auto vals = std::vector<double>(nnz);
+	std::uniform_int_distribution<size_t> pos(0, N - 1);
+	std::uniform_real_distribution<double> val(-1.0, 1.0);
+	for (size_t k = 0; k != nnz; ++k) {
+		rows[k] = pos(g);
+		cols[k] = pos(g);
+		vals[k] = val(g);
+	}
+
+	bench_report("construct", "set_ns_per_nnz", bench_ns(1, [&] {
+		auto m = sparse_matrix2d<double, N, N>();
+		for (size_t k = 0; k != nnz; ++k) {
+			m.set(vals[k], rows[k], cols[k]);
+		}
+	}) / nnz);
+	bench_report("construct", "from_triplets_ns_per_nnz", bench_ns(1, [&] {
+		sparse_matrix2d<double, N, N>::from_triplets(rows, cols, vals);
+	}) / nnz);
+}
+
+template <size_t N>
+void bench_row_access(std::mt19937& g)
+{
+	auto m = bench_random_matrix<N>(N * 8, g);
+	bench_report("row_access", "row_ns_per_nnz", bench_ns(5, [&] {
+		for (size_t i = 0; i != N; ++i) {
+			m.row(i);
+		}
+	}) / m.size());
+	bench_report("row_access", "row_size_ns_per_row", bench_ns(5, [&] {
+		size_t n = 0;
+		for (size_t i = 0; i != N; ++i) {
+			n += m.row_size(i);
+		}
+		return n;
+	}) / N);
+}
+
+template <size_t N>
+void bench_semiring(std::mt19937& g)
+{
+	auto m = bench_random_matrix<N>(N * 8, g);
+	auto csr = csr_matrix<double, N, N>(m);
+	auto nnz = static_cast<double>(m.size());
+
+	bench_report("spgemm_semiring", "sparse_plus_times_ns_per_nnz", bench_ns(1, [&] { m.Mul(m); }) / nnz);
+	bench_report("spgemm_semiring", "csr_plus_times_ns_per_nnz", bench_ns(2, [&] { csr.Mul(csr); }) / nnz);
+	bench_report("spgemm_semiring", "csr_min_plus_ns_per_nnz", bench_ns(2, [&] { csr.template Mul<min_plus<double>>(csr); }) / nnz);
+}
+
+#ifndef CsrFile_disabled
+template <size_t N>
+void bench_csr_file(std::mt19937& g)
+{
+	auto m = bench_random_matrix<N>(N * 16, g);
+	auto csr = csr_matrix<double, N, N>(m);
+	auto x = std::vector<double>(N, 1.0);
+	auto y = std::vector<double>(N);
+	auto nnz = static_cast<double>(m.size());
+
+	bench_report("csr_file", "write_ns_per_nnz", bench_ns(1, [&] { csr_file::write("DsExpBench_a.bin", csr); }) / nnz);
+	{
+		auto a = csr_file::map<double, N, N>("DsExpBench_a.bin");
+		bench_report("csr_file", "memory_spmv_ns_per_nnz", bench_ns(10, [&] { csr.spmv(x.data(), y.data()); }) / nnz);
+		bench_report("csr_file", "mapped_spmv_ns_per_nnz", bench_ns(10, [&] { a.spmv(x.data(), y.data()); }) / nnz);
+		bench_report("csr_file", "memory_spgemm_ns_per_nnz", bench_ns(1, [&] { csr.Mul(csr); }) / nnz);
+		bench_report("csr_file", "mapped_spgemm_ns_per_nnz", bench_ns(1, [&] { a.Mul(a, "DsExpBench_c.bin"); }) / nnz);
+	}
+	std::remove("DsExpBench_a.bin");
+	std::remove("DsExpBench_c.bin");
+}
+#endif
+
+#ifndef SmallMatrix_disabled
+void bench_small_matrix(std::mt19937& g)
+{
+	std::uniform_real_distribution<double> val(-1.0, 1.0);
+	auto sparse = sparse_matrix2d<double, 4, 4>();
+	for (size_t i = 0; i != 4; ++i) {
+		for (size_t j = 0; j != 4; ++j) {
+			if (val(g) > 0) {
+				sparse.set(val(g), i, j);
+			}
+		}
+	}
+	auto small = small_matrix2d<double, 4, 4>(sparse);
+	auto sink = 0.0;
+
+	bench_report("small4x4", "sparse_mul_ns", bench_ns(100000, [&] { sink += sparse.Mul(sparse).get(0, 0); }));
+	bench_report("small4x4", "small_mul_ns", bench_ns(100000, [&] { sink += small.Mul(small).get(0, 0); }));
+	bench_report("small4x4", "sparse_add_ns", bench_ns(100000, [&] { sink += sparse.Add(sparse).get(0, 0); }));
+	bench_report("small4x4", "small_add_ns", bench_ns(100000, [&] { sink += small.Add(small).get(0, 0); }));
+	bench_report("small4x4", "sparse_rev_ns", bench_ns(100000, [&] { sink += sparse.Rev().get(0, 0); }));
+	bench_report("small4x4", "small_rev_ns", bench_ns(100000, [&] { sink += small.Rev().get(0, 0); }));
+	if (sink == 42.0) {
+		std::cout << std::endl;
+	}
+}
+#endif
+
+#if !defined(CsrMatrix_disabled) && !defined(HybridMatrix_disabled)
+template <size_t N>
+void bench_hybrid(size_t density, std::mt19937& g)
+{
+	auto t = bench_generate<N>(bench_shape::PowerLaw, density, g);
+	auto m = sparse_matrix2d<double, N, N>::from_triplets(t.rows, t.cols, t.vals);
+	auto csr = csr_matrix<double, N, N>(m);
+	auto hyb = hybrid_matrix<double, N, N>(m);
+	auto x = std::vector<double>(N, 1.0);
+	auto y = std::vector<double>(N);
+	auto nnz = static_cast<double>(m.size());
+	auto sink = 0.0;
+
+	bench_report("hybrid_powerlaw", "dense_rows", static_cast<double>(hyb.dense_rows()));
+	bench_report("hybrid_powerlaw", "csr_bytes", static_cast<double>((N + 1 + csr.size()) * sizeof(size_t) + csr.size() * sizeof(double)));
+	bench_report("hybrid_powerlaw", "hybrid_bytes", static_cast<double>(hyb.bytes()));
+	bench_report("hybrid_powerlaw", "csr_get_ns_per_nnz", bench_ns(1, [&] {
+		for (size_t k = 0; k != t.vals.size(); ++k) {
+			sink += csr.get(t.rows[k], t.cols[k]);
+		}
+	}) / t.vals.size());
+	bench_report("hybrid_powerlaw", "hybrid_get_ns_per_nnz", bench_ns(1, [&] {
+		for (size_t k = 0; k != t.vals.size(); ++k) {
+			sink += hyb.get(t.rows[k], t.cols[k]);
+		}
+	}) / t.vals.size());
+	bench_report("hybrid_powerlaw", "csr_spmv_ns_per_nnz", bench_ns(10, [&] { csr.spmv(x.data(), y.data()); }) / nnz);
+	bench_report("hybrid_powerlaw", "hybrid_spmv_ns_per_nnz", bench_ns(10, [&] { hyb.spmv(x.data(), y.data()); }) / nnz);
+	bench_report("hybrid_powerlaw", "csr_spgemm_ns_per_nnz", bench_ns(1, [&] { sink += csr.Mul(csr).size(); }) / nnz);
+	bench_report("hybrid_powerlaw", "hybrid_spgemm_ns_per_nnz", bench_ns(1, [&] { sink += hyb.Mul(hyb).size(); }) / nnz);
+	if (sink == 42.0) {
+		std::cout << std::endl;
+	}
+}
+#endif
+
+/**
+ * \brief 生成side*side的网格道路图，边权为1到100的随机整数
+ * \param side 网格边长
+ * \param g 随机数发生器
+ * \return 无向图的邻接表
+ */
+std::vector<std::vector<std::pair<size_t, int>>> bench_grid_graph(size_t side, std::mt19937& g)
+{
+	auto m = std::vector<std::vector<std::pair<size_t, int>>>(side * side);
+	auto w = std::uniform_int_distribution<int>(1, 100);
+	for (size_t r = 0; r != side; ++r) {
+		for (size_t c = 0; c != side; ++c) {
+			auto v = r * side + c;
+			if (c + 1 != side) {
+				auto x = w(g);
+				m[v].emplace_back(v + 1, x);
+				m[v + 1].emplace_back(v, x);
+			}
+			if (r + 1 != side) {
+				auto x = w(g);
+				m[v].emplace_back(v + side, x);
+				m[v + side].emplace_back(v, x);
+			}
+		}
+	}
+	return m;
+}
+
+#ifndef Dijkstra_disabled
+/**
+ * \brief 比较dijkstra与不同线程数的delta_stepping
+ * \param side 网格边长，顶点数为side*side
+ * \param g 随机数发生器
+ */
+void bench_sssp(size_t side, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto ref = dijkstra(m, 0);
+	bench_report("sssp_grid", "vertices", static_cast<double>(m.size()));
+	bench_report("sssp_grid", "dijkstra_ms", bench_ns(1, [&] { ref = dijkstra(m, 0); }) / 1e6);
+	for (size_t threads : { 1, 2, 4 }) {
+		auto d = std::vector<int>();
+		auto metric = "delta_stepping_t" + std::to_string(threads) + "_ms";
+		bench_report("sssp_grid", metric.c_str(), bench_ns(1, [&] { d = delta_stepping(m, 0, 0, threads); }) / 1e6);
+		if (d != ref) {
+			std::cerr << "delta_stepping mismatch" << std::endl;
+		}
+	}
+}
+#endif
+
+#ifndef Dijkstra_disabled
+/**
+ * \brief 生成连通的随机无向图边列表，边权为1到100的随机整数
+ * \details 每个顶点连向下一个顶点以保证连通，其余边的终点随机
+ * \param n 顶点数
+ * \param degree 每个顶点的无向边数
+ * \param g 随机数发生器
+ * \return 边列表，共n * degree条
+ */
+std::vector<csr_graph::edge_t> bench_graph_edges(size_t n, size_t degree, std::mt19937& g)
+{
+	auto edges = std::vector<csr_graph::edge_t>();
+	edges.reserve(n * degree);
+	auto w = std::uniform_int_distribution<int>(1, 100);
+	for (size_t i = 0; i != n; ++i) {
+		for (size_t k = 0; k != degree; ++k) {
+			edges.emplace_back(w(g), i, k == 0 ? (i + 1) % n : g() % n);
+		}
+	}
+	return edges;
+}
+
+/**
+ * \brief 比较dijkstra的各优先队列策略
+ * \param name 测试名
+ * \param n 顶点数
+ * \param degree 每个顶点的无向边数
+ * \param g 随机数发生器
+ */
+void bench_queue(const char* name, size_t n, size_t degree, std::mt19937& g)
+{
+	auto csr = csr_graph32::from_edges(n, bench_graph_edges(n, degree, g), true);
+	auto ref = dijkstra<lazy_binary_heap>(csr, 0);
+	auto sink = size_t(0);
+	bench_report(name, "edges", static_cast<double>(csr.edges()));
+	bench_report(name, "lazy_binary_heap_ms", bench_ns(3, [&] { sink += dijkstra<lazy_binary_heap>(csr, 0) == ref; }) / 1e6);
+	bench_report(name, "radix_heap_ms", bench_ns(3, [&] { sink += dijkstra<radix_heap>(csr, 0) == ref; }) / 1e6);
+	bench_report(name, "indexed_4ary_heap_ms", bench_ns(3, [&] { sink += dijkstra<indexed_dary_heap<4>>(csr, 0) == ref; }) / 1e6);
+	bench_report(name, "pairing_heap_ms", bench_ns(3, [&] { sink += dijkstra<pairing_heap>(csr, 0) == ref; }) / 1e6);
+	if (sink != 12) {
+		std::cerr << "queue mismatch" << std::endl;
+	}
+}
+
+/**
+ * \brief 比较全图dijkstra、双向搜索与A*的点对点查询延迟
+ * \param side 网格边长，顶点数为side*side
+ * \param radius 起点与终点的最大行列差，为0时不限制
+ * \param queries 查询次数
+ * \param g 随机数发生器
+ */
+void bench_point_to_point(size_t side, size_t radius, size_t queries, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto edges = std::vector<csr_graph::edge_t>();
+	for (size_t u = 0; u != m.size(); ++u) {
+		for (auto const& e : m[u]) {
+			edges.emplace_back(e.second, u, e.first);
+		}
+	}
+	auto csr = csr_graph32::from_edges(m.size(), edges);
+	auto pairs = std::vector<std::pair<size_t, size_t>>();
+	auto coord = std::uniform_int_distribution<size_t>(0, side - 1);
+	while (pairs.size() != queries) {
+		auto r = coord(g), c = coord(g), r2 = coord(g), c2 = coord(g);
+		if (radius == 0 || (std::max(r, r2) - std::min(r, r2) <= radius && std::max(c, c2) - std::min(c, c2) <= radius)) {
+			pairs.emplace_back(r * side + c, r2 * side + c2);
+		}
+	}
+	auto name = std::string(radius == 0 ? "p2p_random" : "p2p_local");
+	auto sink = size_t(0);
+	auto mismatch = size_t(0);
+	auto full = std::vector<int>();
+	for (auto const& p : pairs) {
+		full.push_back(dijkstra<lazy_binary_heap>(csr, p.first)[p.second]);
+	}
+	bench_report(name.c_str(), "dijkstra_ms_per_query", bench_ns(1, [&] {
+		for (auto const& p : pairs) {
+			sink += dijkstra<lazy_binary_heap>(csr, p.first)[p.second];
+		}
+	}) / 1e6 / queries);
+	bench_report(name.c_str(), "bidirectional_ms_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			mismatch += shortest_path(csr, pairs[i].first, pairs[i].second).distance != full[i];
+		}
+	}) / 1e6 / queries);
+	bench_report(name.c_str(), "a_star_ms_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			auto t = pairs[i].second;
+			auto h = [side, t](size_t v) {
+				auto dr = v / side > t / side ? v / side - t / side : t / side - v / side;
+				auto dc = v % side > t % side ? v % side - t % side : t % side - v % side;
+				return static_cast<int>(dr + dc);
+			};
+			mismatch += a_star(csr, pairs[i].first, t, h).distance != full[i];
+		}
+	}) / 1e6 / queries);
+	auto fw = dijkstra_workspace(csr.vertices());
+	auto bw = dijkstra_workspace(csr.vertices());
+	bench_report(name.c_str(), "bidirectional_workspace_ms_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			mismatch += shortest_path(csr, csr, pairs[i].first, pairs[i].second, fw, bw).distance != full[i];
+		}
+	}) / 1e6 / queries);
+	if (sink == 0 || mismatch != 0) {
+		std::cerr << "point to point mismatch" << std::endl;
+	}
+}
+
+
+/**
+ * \brief 比较不同边权类型的dijkstra
+ * \param side 网格边长，顶点数为side*side
+ * \param g 随机数发生器
+ */
+void bench_weight_types(size_t side, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto edges = std::vector<csr_graph::edge_t>();
+	for (size_t u = 0; u != m.size(); ++u) {
+		for (auto const& e : m[u]) {
+			edges.emplace_back(e.second, u, e.first);
+		}
+	}
+	auto csr = csr_graph32::from_edges(m.size(), edges);
+	auto convert = [&csr](auto w) {
+		using W = decltype(w);
+		return basic_csr_graph<std::uint32_t, W>(csr.offsets(), csr.targets(), std::vector<W>(csr.weights().begin(), csr.weights().end()));
+	};
+	auto g64 = convert(std::int64_t());
+	auto gd = convert(double());
+	auto ref = dijkstra(csr, 0);
+	auto mismatch = size_t(0);
+	bench_report("weight_grid", "int_ms", bench_ns(1, [&] { mismatch += dijkstra<std::uint32_t, int>(csr, 0) != ref; }) / 1e6);
+	bench_report("weight_grid", "int64_ms", bench_ns(1, [&] { mismatch += dijkstra(g64, 0).back() != ref.back(); }) / 1e6);
+	bench_report("weight_grid", "double_ms", bench_ns(1, [&] { mismatch += dijkstra(gd, 0).back() != ref.back(); }) / 1e6);
+	if (mismatch != 0) {
+		std::cerr << "weight type mismatch" << std::endl;
+	}
+}
+
+/**
+ * \brief 比较逐个调用dijkstra与复用工作区的批量dijkstra
+ * \param side 网格边长，顶点数为side*side
+ * \param sources 起点个数
+ * \param g 随机数发生器
+ */
+void bench_batch(size_t side, size_t sources, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto edges = std::vector<csr_graph::edge_t>();
+	for (size_t u = 0; u != m.size(); ++u) {
+		for (auto const& e : m[u]) {
+			edges.emplace_back(e.second, u, e.first);
+		}
+	}
+	auto csr = csr_graph32::from_edges(m.size(), edges);
+	auto src = std::vector<size_t>(sources);
+	for (auto& x : src) {
+		x = g() % m.size();
+	}
+	auto sum = [&csr](dijkstra_workspace const& ws) {
+		auto ret = size_t(0);
+		for (size_t v = 0; v != csr.vertices(); ++v) {
+			ret += ws.distance(v);
+		}
+		return ret;
+	};
+	auto expect = size_t(0);
+	auto name = "batch_grid";
+	bench_report(name, "sources", static_cast<double>(sources));
+	bench_report(name, "fresh_ms", bench_ns(1, [&] {
+		for (auto s : src) {
+			auto d = dijkstra<lazy_binary_heap>(csr, s);
+			expect += std::accumulate(d.begin(), d.end(), size_t(0));
+		}
+	}) / 1e6);
+	auto ws = dijkstra_workspace(csr.vertices());
+	auto total = size_t(0);
+	bench_report(name, "workspace_ms", bench_ns(1, [&] {
+		for (auto s : src) {
+			dijkstra(csr, s, ws);
+			total += sum(ws);
+		}
+	}) / 1e6);
+	for (size_t threads : { 1, 2, 4 }) {
+		auto part = std::vector<size_t>(sources);
+		auto metric = "batch_t" + std::to_string(threads) + "_ms";
+		bench_report(name, metric.c_str(), bench_ns(1, [&] {
+			dijkstra_batch(csr, src, [&part, &sum](size_t i, dijkstra_workspace const& w) { part[i] = sum(w); }, threads);
+		}) / 1e6);
+		total += std::accumulate(part.begin(), part.end(), size_t(0));
+	}
+	if (total != 4 * expect) {
+		std::cerr << "batch mismatch" << std::endl;
+	}
+}
+#endif
+
+#ifndef ContractionHierarchy_disabled
+/**
+ * \brief 收缩层次的预处理时间、索引大小与查询延迟
+ * \param side 网格边长，顶点数为side*side
+ * \param queries 查询次数
+ * \param g 随机数发生器
+ */
+void bench_contraction(size_t side, size_t queries, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto edges = std::vector<csr_graph::edge_t>();
+	for (size_t u = 0; u != m.size(); ++u) {
+		for (auto const& e : m[u]) {
+			edges.emplace_back(e.second, u, e.first);
+		}
+	}
+	auto csr = csr_graph::from_edges(m.size(), edges);
+	auto pairs = std::vector<std::pair<size_t, size_t>>(queries);
+	for (auto& p : pairs) {
+		p = std::make_pair(g() % m.size(), g() % m.size());
+	}
+	auto ch = std::vector<contraction_hierarchy>();
+	bench_report("ch_grid", "vertices", static_cast<double>(m.size()));
+	bench_report("ch_grid", "preprocess_ms", bench_ns(1, [&] { ch.emplace_back(m); }) / 1e6);
+	bench_report("ch_grid", "shortcuts", static_cast<double>(ch[0].shortcuts()));
+	bench_report("ch_grid", "graph_bytes", static_cast<double>(csr.bytes()));
+	bench_report("ch_grid", "index_bytes", static_cast<double>(ch[0].bytes()));
+	auto full = std::vector<int>();
+	auto mismatch = size_t(0);
+	bench_report("ch_grid", "dijkstra_us_per_query", bench_ns(1, [&] {
+		for (auto const& p : pairs) {
+			full.push_back(dijkstra<lazy_binary_heap>(csr, p.first)[p.second]);
+		}
+	}) / 1e3 / queries);
+	auto fw = dijkstra_workspace(m.size());
+	auto bw = dijkstra_workspace(m.size());
+	bench_report("ch_grid", "bidirectional_us_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			mismatch += shortest_path(csr, csr, pairs[i].first, pairs[i].second, fw, bw).distance != full[i];
+		}
+	}) / 1e3 / queries);
+	bench_report("ch_grid", "ch_distance_us_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			mismatch += ch[0].distance(pairs[i].first, pairs[i].second, fw, bw) != full[i];
+		}
+	}) / 1e3 / queries);
+	bench_report("ch_grid", "ch_path_us_per_query", bench_ns(1, [&] {
+		for (size_t i = 0; i != queries; ++i) {
+			mismatch += ch[0].query(pairs[i].first, pairs[i].second, fw, bw).distance != full[i];
+		}
+	}) / 1e3 / queries);
+	if (mismatch != 0) {
+		std::cerr << "contraction hierarchy mismatch" << std::endl;
+	}
+}
+#endif
+
+#ifndef DynamicSssp_disabled
+/**
+ * \brief 网格道路图上随机改权后的增量修复与重新计算dijkstra的延迟
+ * \param side 网格边长，顶点数为side*side
+ * \param updates 改权次数
+ * \param g 随机数发生器
+ */
+void bench_dynamic_sssp(size_t side, size_t updates, std::mt19937& g)
+{
+	auto m = bench_grid_graph(side, g);
+	auto w = std::uniform_int_distribution<int>(1, 100);
+	auto changes = std::vector<std::tuple<size_t, size_t, int>>(updates);
+	for (auto& c : changes) {
+		auto u = g() % m.size();
+		auto k = g() % m[u].size();
+		c = std::make_tuple(u, k, w(g));
+	}
+	auto sp = std::vector<dynamic_sssp>();
+	bench_report("dynamic_grid", "vertices", static_cast<double>(m.size()));
+	bench_report("dynamic_grid", "build_ms", bench_ns(1, [&] { sp.emplace_back(m, 0); }) / 1e6);
+	auto affected = size_t(0);
+	bench_report("dynamic_grid", "update_us", bench_ns(1, [&] {
+		for (auto const& c : changes) {
+			auto u = std::get<0>(c);
+			sp[0].update(u, m[u][std::get<1>(c)].first, std::get<2>(c));
+			affected += sp[0].last_affected();
+		}
+	}) / 1e3 / updates);
+	bench_report("dynamic_grid", "affected_per_update", static_cast<double>(affected) / updates);
+	auto d = std::vector<int>();
+	auto recompute = std::min(updates, size_t(20));
+	bench_report("dynamic_grid", "dijkstra_us", bench_ns(1, [&] {
+		for (size_t i = 0; i != recompute; ++i) {
+			auto const& c = changes[i];
+			m[std::get<0>(c)][std::get<1>(c)].second = std::get<2>(c);
+			d = dijkstra(m, 0);
+		}
+	}) / 1e3 / recompute);
+	for (auto i = recompute; i != updates; ++i) {
+		auto const& c = changes[i];
+		m[std::get<0>(c)][std::get<1>(c)].second = std::get<2>(c);
+	}
+	if (dijkstra(m, 0) != sp[0].distances()) {
+		std::cerr << "dynamic_sssp mismatch" << std::endl;
+	}
+}
+#endif
+
+#ifndef AllPairs_disabled
+/**
+ * \brief 比较分块Floyd–Warshall与逐个起点dijkstra的全源最短路，并给出自动选择的结果
+ * \param name 测试名
+ * \param n 顶点数
+ * \param degree 每个顶点的出边数
+ * \param g 随机数发生器
+ */
+void bench_all_pairs(const char* name, size_t n, size_t degree, std::mt19937& g)
+{
+	auto edges = std::vector<csr_graph::edge_t>();
+	for (size_t u = 0; u != n; ++u) {
+		for (size_t k = 0; k != degree; ++k) {
+			edges.emplace_back(static_cast<int>(g() % 100 + 1), u, g() % n);
+		}
+	}
+	auto csr = csr_graph::from_edges(n, edges);
+	auto fw = std::vector<int>();
+	auto dj = std::vector<int>();
+	bench_report(name, "vertices", static_cast<double>(n));
+	bench_report(name, "edges", static_cast<double>(csr.edges()));
+	bench_report(name, "auto_selects_floyd_warshall", apsp_select(csr) == apsp_method::FloydWarshall ? 1 : 0);
+	bench_report(name, "floyd_warshall_ms", bench_ns(1, [&] { fw = all_pairs(csr, apsp_method::FloydWarshall); }) / 1e6);
+	bench_report(name, "dijkstra_ms", bench_ns(1, [&] { dj = all_pairs(csr, apsp_method::Dijkstra); }) / 1e6);
+	if (fw != dj) {
+		std::cerr << "all_pairs mismatch" << std::endl;
+	}
+}
+#endif
+
+#if !defined(Dijkstra_disabled) && !defined(Kruskal_disabled)
+/**
+ * \brief 比较邻接表与CSR图上的dijkstra和kruskal
+ * \param n 顶点数
+ * \param degree 每个顶点的无向边数，总边数(双向)为2 * n * degree
+ * \param g 随机数发生器
+ */
+void bench_csr_graph(size_t n, size_t degree, std::mt19937& g)
+{
+	auto edges = bench_graph_edges(n, degree, g);
+	auto m = std::vector<std::vector<std::pair<size_t, int>>>(n);
+	auto csr = csr_graph();
+	auto csr32 = csr_graph32();
+	bench_report("graph_random", "edges", static_cast<double>(2 * edges.size()));
+	bench_report("graph_random", "adjacency_build_ms", bench_ns(1, [&] {
+		for (auto const& e : edges) {
+			m[std::get<1>(e)].emplace_back(std::get<2>(e), std::get<0>(e));
+			m[std::get<2>(e)].emplace_back(std::get<1>(e), std::get<0>(e));
+		}
+	}) / 1e6);
+	bench_report("graph_random", "csr_build_ms", bench_ns(1, [&] { csr = csr_graph::from_edges(n, edges, true); }) / 1e6);
+	bench_report("graph_random", "csr32_build_ms", bench_ns(1, [&] { csr32 = csr_graph32::from_edges(n, edges, true); }) / 1e6);
+	bench_report("graph_random", "csr_bytes", static_cast<double>(csr.bytes()));
+	bench_report("graph_random", "csr32_bytes", static_cast<double>(csr32.bytes()));
+	auto d = std::vector<int>();
+	auto sink = size_t(0);
+	bench_report("graph_random", "adjacency_dijkstra_ms", bench_ns(1, [&] { d = dijkstra(m, 0); }) / 1e6);
+	bench_report("graph_random", "csr_dijkstra_ms", bench_ns(1, [&] { sink += dijkstra(csr, 0) == d; }) / 1e6);
+	bench_report("graph_random", "csr32_dijkstra_ms", bench_ns(1, [&] { sink += dijkstra(csr32, 0) == d; }) / 1e6);
+	bench_report("graph_random", "adjacency_kruskal_ms", bench_ns(1, [&] { sink += kruskal(m).size(); }) / 1e6);
+	bench_report("graph_random", "csr_kruskal_ms", bench_ns(1, [&] { sink += kruskal(csr).size(); }) / 1e6);
+	bench_report("graph_random", "csr32_kruskal_ms", bench_ns(1, [&] { sink += kruskal(csr32).size(); }) / 1e6);
+	if (sink != 2 + 3 * (n - 1)) {
+		std::cerr << "csr_graph mismatch" << std::endl;
+	}
+}
+#endif
+
+#if !defined(Dijkstra_disabled) && !defined(Kruskal_disabled)
+/**
+ * \brief 比较kruskal、filter-Kruskal与并行Borůvka
+ * \param name 测试名
+ * \param n 顶点数
+ * \param degree 每个顶点的无向边数
+ * \param g 随机数发生器
+ */
+void bench_mst(const char* name, size_t n, size_t degree, std::mt19937& g)
+{
+	auto csr = csr_graph32();
+	{
+		auto edges = bench_graph_edges(n, degree, g);
+		csr = csr_graph32::from_edges(n, edges, true);
+	}
+	auto x = std::vector<std::tuple<int, size_t, size_t>>();
+	auto mismatch = size_t(0);
+	bench_report(name, "edges", static_cast<double>(csr.edges() / 2));
+	bench_report(name, "kruskal_ms", bench_ns(1, [&] { x = kruskal(csr); }) / 1e6);
+	for (auto threads : { 1, 4 }) {
+		auto metric = "filter_kruskal_ms_t" + std::to_string(threads);
+		bench_report(name, metric.c_str(), bench_ns(1, [&] { mismatch += filter_kruskal(csr, threads) != x; }) / 1e6);
+	}
+	for (auto threads : { 1, 4, 16 }) {
+		auto metric = "boruvka_ms_t" + std::to_string(threads);
+		bench_report(name, metric.c_str(), bench_ns(1, [&] { mismatch += boruvka(csr, threads) != x; }) / 1e6);
+	}
+	if (mismatch != 0) {
+		std::cerr << "mst mismatch" << std::endl;
+	}
+}
+#endif
+
+/**
+ * \brief 基准测试入口，结果以CSV输出到标准输出
+ * \details 用法：DsExpBench [每行元素个数=8] [最大规模log2=16] [随机种子=42]，规模取2^12、2^16与2^20中不超过上限者
+ */
+int main(int argc, char* argv[])
+{
+	auto density = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8ul;
+	auto max_log2 = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 16ul;
+	std::mt19937 g(argc > 3 ? static_cast<std::mt19937::result_type>(std::strtoul(argv[3], nullptr, 10)) : 42u);
+	std::cout << "bench,metric,value" << std::endl;
+
+	//++Start SparseMatrix suite bench
+	if (max_log2 >= 12) {
+		bench_suites<1 << 12>(density, g);
+	}
+	if (max_log2 >= 16) {
+		bench_suites<1 << 16>(density, g);
+	}
+	if (max_log2 >= 20) {
+		bench_suites<1 << 20>(density, g);
+	}
+	//++End SparseMatrix suite bench
+
+#if !defined(CsrMatrix_disabled) && !defined(BsrMatrix_disabled)
+	//++Start BsrMatrix bench
+	bench_bsr_vs_csr<4096, 4>("bsr4_spmv", "bsr4_spgemm", g);
+	bench_bsr_vs_csr<4096, 8>("bsr8_spmv", "bsr8_spgemm", g);
+	//++End BsrMatrix bench
+#endif
+
+#ifndef CsrMatrix_disabled
+	//++Start Semiring bench
+	bench_semiring<16384>(g);
+	//++End Semiring bench
+#endif
+
+#ifndef CsrFile_disabled
+	//++Start CsrFile bench
+	bench_csr_file<1 << 18>(g);
+	//++End CsrFile bench
+#endif
+
+#if !defined(CsrMatrix_disabled) && !defined(HybridMatrix_disabled)
+	//++Start HybridMatrix bench
+	bench_hybrid<1 << 14>(64, g);
+	//++End HybridMatrix bench
+#endif
+
+#ifndef SmallMatrix_disabled
+	//++Start SmallMatrix bench
+	bench_small_matrix(g);
+	//++End SmallMatrix bench
+#endif
+
+#ifndef Dijkstra_disabled
+	//++Start Dijkstra bench
+	bench_sssp(1024, g);
+	bench_queue("queue_sparse", 1 << 20, 4, g);
+	bench_queue("queue_dense", 2048, 1024, g);
+	bench_point_to_point(1024, 0, 20, g);
+	bench_point_to_point(1024, 32, 200, g);
+	bench_batch(64, 10000, g);
+	bench_weight_types(1024, g);
+	//++End Dijkstra bench
+#endif
+
+#ifndef ContractionHierarchy_disabled
+	//++Start ContractionHierarchy bench
+	bench_contraction(128, 1000, g);
+	//++End ContractionHierarchy bench
+#endif
+
+#ifndef DynamicSssp_disabled
+	//++Start DynamicSssp bench
+	bench_dynamic_sssp(512, 10000, g);
+	//++End DynamicSssp bench
+#endif
+
+#ifndef AllPairs_disabled
+	//++Start AllPairs bench
+	bench_all_pairs("apsp_1k_sparse", 1 << 10, 8, g);
+	bench_all_pairs("apsp_1k_dense", 1 << 10, 128, g);
+	if (max_log2 >= 16) {
+		bench_all_pairs("apsp_4k", 1 << 12, 16, g);
+	}
+	if (max_log2 >= 20) {
+		bench_all_pairs("apsp_8k", 1 << 13, 16, g);
+	}
+	//++End AllPairs bench
+#endif
+
+#if !defined(Dijkstra_disabled) && !defined(Kruskal_disabled)
+	//++Start CsrGraph bench
+	bench_csr_graph(1 << 20, 5, g);
+	//++End CsrGraph bench
+#endif
+
+#if !defined(Dijkstra_disabled) && !defined(Kruskal_disabled)
+	//++Start Kruskal bench
+	bench_mst("mst_8m", 1 << 20, 8, g);
+	if (max_log2 >= 20) {
+		bench_mst("mst_50m", 1 << 23, 6, g);
+	}
+	//++End Kruskal bench
+#endif
+
+	//++Start SparseMatrix construction bench
+	bench_construction<1 << 20>(1 << 21, g);
+	//++End SparseMatrix construction bench
+
+	//++Start SparseMatrix row access bench
+	bench_row_access<65536>(g);
+	//++End SparseMatrix row access bench
+
+	//++Start SparseMatrix expression bench
+	bench_expression<65536>(g);
+	//++End SparseMatrix expression bench
+
+	return 0;
+}
@@ -8,7 +8,20 @@
 #include "src/BinaryTree.hpp"
 #include "src/Dijkstra.h"
 #include "src/Kruskal.h"
+#include "src/CsrGraph.hpp"
+#include "src/Parallel.hpp"
+#include "src/DisjointSet.hpp"
 #include "src/AVL.hpp"
+#include "src/MatrixMarket.hpp"
+#include "src/CsrMatrix.hpp"
+#include "src/BsrMatrix.hpp"
+#include "src/SparseSolver.hpp"
+#include "src/CsrFile.hpp"
+#include "src/SmallMatrix.hpp"
+#include "src/HybridMatrix.hpp"
+#include "src/ContractionHierarchy.h"
+#include "src/AllPairs.hpp"
+#include "src/DynamicSssp.h"
 #include "main.h"
 
 #include <iostream>
@@ -20,6 +33,11 @@
 #include <numeric>
 #include <algorithm>
 #include <random>
+#include <limits>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 
 int main()
 {
@@ -74,11 +92,35 @@ int main()
 		auto mat3 = mat * mat2;
 		auto mat4 = mat3.Rev();
 
-		assert((mat3.have<0, 0>(out) && out == 14));
-		assert((mat3.get<1, 0>() == 28));
-		assert((mat4.get<0, 0>() == 14));
-		assert((mat4.get<0, 1>() == 28));
-		//assert((mat4.get<0, 2>() == 28)); //将会触发编译器报错：Matrix bound check failed
+		assert((mat3.have<0, 0>(out) && out == 5));
+		assert((mat3.get<1, 0>() == 8));
+		assert((mat4.get<0, 0>() == 5));
+		assert((mat4.get<0, 1>() == 8));
+		//assert((mat4.get<0, 2>() == 8)); //将会触发编译器报错：Matrix bound check failed
+
+		auto graph = sparse_matrix2d<int, 4, 4>({ { 0,3,0,0 },{ 0,0,1,0 },{ 0,0,0,2 },{ 1,0,0,0 } });
+		for (size_t i = 0; i != 4; ++i) {
+			graph.set(0, i, i);
+		}
+		auto graph2 = graph.Mul<min_plus<int>>(graph);
+		auto dist = graph2.Mul<min_plus<int>>(graph2);
+		assert(dist.size() == 16);
+		assert(dist.have(0, 0, out) && out == 0);
+		assert(dist.get(0, 3) == 6);
+		assert(dist.get(1, 0) == 4);
+		assert(!graph2.have(0, 3, out));
+		assert(graph2.get(0, 3) == 0);
+		assert(graph2.get<min_plus<int>>(0, 3) == min_plus<int>::zero());
+		assert(min_plus<int>::mul(-3, -4) == -7);
+		assert(min_plus<int>::mul(std::numeric_limits<int>::min() + 1, -5) == std::numeric_limits<int>::min());
+		assert(min_plus<int>::mul(std::numeric_limits<int>::max() - 1, 5) == min_plus<int>::zero());
+		assert(dist.get<min_plus<int>>(0, 3) == 6);
+		auto reach = graph.Mul<or_and<int>>(graph);
+		assert(reach.size() == 4);
+		assert(reach.get(0, 2) == 1 && reach.get(3, 1) == 1);
+		auto width = graph.Mul<max_min<int>>(graph);
+		assert(width.get(0, 2) == 1);
+		assert(width.get(0, 1) == 0);
 
 		auto mat5 = sparse_matrix2d<int, 2, 3>();
 		mat5.set(1, 0, 0);
@@ -92,10 +134,38 @@ int main()
 		assert(m5r0.size() == 2);
 		assert(m5r0[1].second == 1);
 
+		auto shared = sparse_matrix2d<int, 512, 512>();
+		for (size_t i = 0; i != 512; ++i) {
+			shared.set(1, i, i);
+			shared.set(2, i, (i * 7) % 512);
+		}
+		auto counted = std::vector<size_t>(4);
+		parallel_for(4, 4, [&shared, &counted](size_t, size_t b, size_t e) {
+			for (auto t = b; t != e; ++t) {
+				for (size_t i = 0; i != 512; ++i) {
+					counted[t] += shared.row_size(i) + shared.row(i).size();
+				}
+			}
+		});
+		for (auto c : counted) {
+			assert(c == 2 * shared.size());
+		}
+
 		auto m5r1 = mat5.row<1>();
 		assert(m5r1.size() == 1);
 		assert(m5r1[0].second == 2);
 
+		assert(mat5.row_size(0) == 2 && mat5.row_size(1) == 1);
+		auto mat5c = mat5;
+		mat5.set(3, 1, 0);
+		mat5.set(4, 1, 2);
+		assert(mat5.row_size(1) == 2);
+		assert(mat5.row(1)[0].second == 3);
+		assert(mat5c.row_size(1) == 1);
+		assert(mat5c.row(1)[0].second == 2);
+		mat5 = mat5c;
+		assert(mat5.row_size(1) == 1);
+
 		try {
 			mat5.row(4);
 			throw std::runtime_error("std::out_of_range expected");
@@ -104,6 +174,13 @@ int main()
 			assert(std::string(e.what()) == "Matrix bound check failed");
 		}
 
+		try{
+			mat5.get(2, 0);
+			throw std::runtime_error("std::out_of_range expected");
+		}catch(std::out_of_range& e){
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+
 		try{
 			mat5.get(3, 5);
 			throw std::runtime_error("std::out_of_range expected");
@@ -113,13 +190,129 @@ int main()
 
 		auto mat6 = mat - mat5;
 		assert((mat6.get<1, 2>() == 2));
+		assert(mat6.eval().size() == 1);
+		assert(mat6.eval().row(0).size() == 0);
+
+		sparse_matrix2d<int, 2, 3> mat6a = mat + mat5;
+		assert(mat6a.size() == 3);
+		assert((mat6a.get<0, 1>() == 2));
+		assert((mat6a.get<1, 2>() == 6));
+		auto m6ar1 = mat6a.row(1);
+		assert(m6ar1.size() == 1 && m6ar1[0].first == 2);
+
+		auto mat6b = mat.Axpby(2, mat5, -2);
+		assert(mat6b.size() == 1);
+		assert((mat6b.get<1, 2>() == 4));
+		auto mat6c = mat.Axpby(3, mat6, 1);
+		assert((mat6c.get<0, 0>() == 3));
+		assert((mat6c.get<1, 2>() == 14));
+
+		auto expr = mat + mat5 - 2 * mat6 - mat5 * 3;
+		assert((expr.get<0, 1>() == -1));
+		assert(expr.get(1, 2) == -4);
+		sparse_matrix2d<int, 2, 3> mat6d = expr;
+		assert(mat6d.size() == 3);
+		assert((mat6d.get<0, 0>() == -1));
+		mat6d = mat6d - mat6d;
+		assert(mat6d.size() == 0);
+
+		auto expr2 = mat.Rev().Rev() + sparse_matrix2d<int, 2, 3>({ { 0,0,0 },{ 0,0,1 } });
+		std::stringstream ss6, ss7;
+		ss6 << expr2;
+		assert(ss6.str() == "1 1 0\n0 0 5\n");
+		ss6.str("");
+		ss6 << (mat + mat5) * mat2;
+		ss7 << mat6a * mat2;
+		assert(ss6.str() == ss7.str());
 		std::stringstream ss;
 		ss << mat;
 		assert(ss.str() == "1 1 0\n0 0 4\n");
 
+		auto mat8 = sparse_matrix2d<int, 3, 4>({ { 1,0,2,0 },{ 0,3,4,0 },{ 5,0,0,6 } });
+		std::stringstream ss8, ss9;
+		ss8 << mat8.Rev();
+		assert(ss8.str() == "1 0 5\n0 3 0\n2 4 0\n0 0 6\n");
+		ss9 << mat8.Rev(3);
+		assert(ss8.str() == ss9.str());
+		auto m8r2 = mat8.Rev().row(2);
+		assert(m8r2.size() == 2 && m8r2[0].first == 0 && m8r2[1].first == 1);
+
+		auto mat9 = sparse_matrix2d<int, 2, 100000>();
+		mat9.set(1, 0, 99999);
+		mat9.set(2, 1, 5);
+		mat9.set(3, 0, 5);
+		auto mat9r = mat9.Rev(2);
+		assert(mat9r.size() == 3);
+		assert(mat9r.row(5).size() == 2);
+		assert(mat9r.row_size(5) == 2 && mat9r.row_size(6) == 0);
+		assert((mat9r.get<99999, 0>() == 1));
+
+		auto mat10 = sparse_matrix2d<int, 3, 4>::from_triplets({ 2, 0, 2, 1, 0, 2 }, { 3, 1, 3, 0, 1, 0 }, { 5, 1, 2, -3, 3, 0 });
+		assert(mat10.size() == 3);
+		assert(mat10.get(2, 3) == 7);
+		assert(mat10.get(0, 1) == 4);
+		assert(mat10.get(1, 0) == -3);
+		assert(mat10.row(2).size() == 1);
+		auto mat11 = sparse_matrix2d<int, 3, 4>::from_triplets({ 2, 2, 1 }, { 3, 3, 1 }, { 5, 2, 1 }, [](int, int b) { return b; });
+		assert(mat11.get(2, 3) == 2);
+		auto mat12 = sparse_matrix2d<int, 3, 4>::from_triplets({ 1, 1 }, { 1, 1 }, { 5, -5 });
+		assert(mat12.size() == 0);
+
+		try {
+			sparse_matrix2d<int, 3, 4>::from_triplets({ 1, 3 }, { 1, 1 }, { 5, 5 });
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+
+		try {
+			sparse_matrix2d<int, 3, 4>::from_triplets({ 1 }, { 1, 1 }, { 5, 5 });
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Vector size check failed");
+		}
+
 		auto mat7 = sparse_matrix2d<int, 2, 3>({ { 0,0,0 },{ 0,0,0 } });
 		assert(mat7.row(0).size() == 0);
 		assert((mat7.row<1>().size() == 0));
+
+#ifdef Use_FoldExp
+		auto tensor = sparse_matrix<int, 3, 4, 5>();
+		tensor.set(7, 2, 3, 4);
+		tensor.set(5, 0, 1, 2);
+		tensor.set(1, 0, 0, 0);
+		tensor.set(9, 2, 3, 4);
+		assert(tensor.size() == 3);
+		assert(tensor.get(2, 3, 4) == 9);
+		assert(tensor.get(0, 1, 2) == 5);
+		assert(tensor.get(1, 1, 1) == 0);
+
+		auto coo = tensor.to_coo();
+		assert(coo.size() == 3);
+		assert(coo[0].first == std::make_tuple(size_t(0), size_t(0), size_t(0)));
+		assert(coo[1].first == std::make_tuple(size_t(0), size_t(1), size_t(2)) && coo[1].second == 5);
+		assert(coo[2].first == std::make_tuple(size_t(2), size_t(3), size_t(4)) && coo[2].second == 9);
+
+		try {
+			tensor.get(1, 4, 0);
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+
+		auto tensor2 = sparse_matrix<size_t, 1000, 1000, 1000, 1000>();
+		for (size_t i = 0; i != 1000; ++i) {
+			tensor2.set(i, i, 999 - i, i, i / 2);
+		}
+		assert(tensor2.size() == 1000);
+		for (size_t i = 0; i != 1000; ++i) {
+			assert(tensor2.get(i, 999 - i, i, i / 2) == i);
+		}
+		assert(tensor2.to_coo().back().second == 999);
+#endif
 	}
 #ifdef Use_Wcout
 	std::wcout << L"SparseMatrix2 测试完成" << std::endl;
@@ -389,6 +582,253 @@ R"(
 		auto ret = dijkstra(map, 0);
 		auto ans = std::array<int, 6>{ {0, 2, 3, 5, 4, 8} };
 		assert(ret == ans);
+		for (auto delta : { 0, 1, 2, 3, 100 }) {
+			for (auto threads : { 1, 4 }) {
+				assert(delta_stepping(map, 0, delta, threads) == ans);
+			}
+		}
+	}
+	{
+		auto g = std::mt19937(7);
+		auto m = std::vector<std::vector<std::pair<size_t, int>>>(3000);
+		for (size_t i = 0; i != m.size(); ++i) {
+			for (auto k = 0; k != 4; ++k) {
+				auto j = g() % m.size();
+				auto w = static_cast<int>(g() % 50 + 1);
+				m[i].emplace_back(j, w);
+				m[j].emplace_back(i, w);
+			}
+		}
+		m.emplace_back();
+		auto ret = dijkstra(m, 0);
+		assert(ret.back() == std::numeric_limits<int>::max());
+		assert(delta_stepping(m, 0) == ret);
+		assert(delta_stepping(m, 0, 1, 2) == ret);
+		assert(delta_stepping(m, 0, 16, 4) == ret);
+		auto big = m;
+		for (auto& adj : big) {
+			for (auto& e : adj) {
+				e.second = 300000000 + static_cast<int>(g() % 200000000);
+			}
+		}
+		auto big_ret = dijkstra(big, 0);
+		assert(delta_stepping(big, 0, 1, 1) == big_ret);
+		assert(delta_stepping(big, 0, 1, 4) == big_ret);
+		auto far = std::vector<std::vector<std::pair<size_t, int>>>(5);
+		far[0] = { { 1, 1000000000 }, { 2, 999999999 } };
+		far[1] = { { 3, 1 } };
+		far[2] = { { 3, 1000000000 }, { 1, 2 } };
+		far[3] = { { 4, 7 } };
+		auto far_ans = std::vector<int>{ 0, 1000000000, 999999999, 1000000001, 1000000008 };
+		for (auto threads : { 1, 2, 4 }) {
+			assert(delta_stepping(far, 0, 1, threads) == far_ans);
+		}
+		auto edges = std::vector<csr_graph::edge_t>();
+		for (size_t i = 0; i != m.size(); ++i) {
+			for (auto const& e : m[i]) {
+				edges.emplace_back(e.second, i, e.first);
+			}
+		}
+		assert(dijkstra(csr_graph::from_edges(m.size(), edges), 0) == ret);
+		assert(dijkstra(csr_graph32::from_edges(m.size(), edges), 0) == ret);
+		auto csr = csr_graph::from_edges(m.size(), edges);
+		assert(dijkstra<lazy_binary_heap>(csr, 0) == ret);
+		assert(dijkstra<radix_heap>(csr, 0) == ret);
+		assert(dijkstra<indexed_dary_heap<>>(csr, 0) == ret);
+		assert(dijkstra<indexed_dary_heap<2>>(csr_graph32::from_edges(m.size(), edges), 0) == ret);
+		assert(dijkstra<pairing_heap>(csr, 0) == ret);
+		assert(dijkstra<pairing_heap>(csr_graph32::from_edges(m.size(), edges), 0) == ret);
+		auto rcsr = csr.reverse();
+		assert(rcsr.edges() == csr.edges());
+		auto weight = [&csr](size_t u, size_t v) {
+			auto w = std::numeric_limits<int>::max();
+			for (auto k = csr.offsets()[u]; k != csr.offsets()[u + 1]; ++k) {
+				if (csr.targets()[k] == v) {
+					w = std::min(w, csr.weights()[k]);
+				}
+			}
+			return w;
+		};
+		for (size_t t = 0; t < m.size(); t += 97) {
+			auto p = shortest_path(csr, rcsr, 0, t);
+			auto a = a_star(csr, 0, t, [](size_t) { return 0; });
+			assert(p.distance == ret[t] && a.distance == ret[t]);
+			assert(p.path.front() == 0 && p.path.back() == t);
+			auto len = 0;
+			for (size_t i = 1; i < p.path.size(); ++i) {
+				len += weight(p.path[i - 1], p.path[i]);
+			}
+			assert(len == ret[t]);
+			assert(a.path.size() >= 1 && a.path.front() == 0 && a.path.back() == t);
+		}
+		auto unreachable = shortest_path(csr, rcsr, 0, m.size() - 1);
+		assert(unreachable.distance == std::numeric_limits<int>::max() && unreachable.path.empty());
+		assert(a_star(csr, 0, m.size() - 1, [](size_t) { return 0; }).path.empty());
+		auto ws = dijkstra_workspace();
+		auto bw = dijkstra_workspace();
+		for (size_t src = 0; src < m.size(); src += 500) {
+			dijkstra(csr, src, ws);
+			auto d = dijkstra(csr, src);
+			for (size_t v = 0; v != m.size(); ++v) {
+				assert(ws.distance(v) == d[v]);
+				assert(ws.reached(v) == (d[v] != std::numeric_limits<int>::max()));
+			}
+			assert(ws.path(src).size() == 1);
+			assert(shortest_path(csr, rcsr, src, 1234, ws, bw).distance == d[1234]);
+			assert(a_star(csr, src, 77, [](size_t) { return 0; }, ws).distance == d[77]);
+		}
+		auto sources = std::vector<size_t>{ 0, 5, 17, 300, 2999, 3000, 42, 1001 };
+		for (auto threads : { 1, 3 }) {
+			auto all = std::vector<std::vector<int>>(sources.size());
+			dijkstra_batch(csr, sources, [&all, &m](size_t i, dijkstra_workspace const& w) {
+				for (size_t v = 0; v != m.size(); ++v) {
+					all[i].push_back(w.distance(v));
+				}
+			}, threads);
+			for (size_t i = 0; i != sources.size(); ++i) {
+				assert(all[i] == dijkstra(csr, sources[i]));
+			}
+		}
+	}
+	{
+		auto edges = std::vector<csr_graph::edge_t>();
+		for (size_t r = 0; r != 4; ++r) {
+			for (size_t c = 0; c != 4; ++c) {
+				if (c != 3) {
+					edges.emplace_back(static_cast<int>(1 + (r + c) % 3), r * 4 + c, r * 4 + c + 1);
+				}
+				if (r != 3) {
+					edges.emplace_back(static_cast<int>(1 + (r * c) % 2), r * 4 + c, r * 4 + c + 4);
+				}
+			}
+		}
+		auto g = csr_graph::from_edges(16, edges, true);
+		auto d = dijkstra(g, 0);
+		auto manhattan = [](size_t v) { return static_cast<int>(3 - v / 4 + 3 - v % 4); };
+		auto a = a_star(g, 0, 15, manhattan);
+		auto p = shortest_path(g, 0, 15);
+		assert(a.distance == d[15] && p.distance == d[15]);
+		assert(a.path.front() == 0 && a.path.back() == 15 && a.path.size() >= 7);
+		assert(p.path.front() == 0 && p.path.back() == 15 && p.path.size() >= 7);
+		assert(shortest_path(g, 5, 5).distance == 0 && shortest_path(g, 5, 5).path.size() == 1);
+		auto gd = basic_csr_graph<std::uint32_t, double>(
+			std::vector<size_t>(g.offsets()), std::vector<std::uint32_t>(g.targets().begin(), g.targets().end()),
+			std::vector<double>(g.weights().begin(), g.weights().end()));
+		auto dd = dijkstra(gd, 0);
+		auto gf = basic_csr_graph<size_t, float>(g.offsets(), g.targets(), std::vector<float>(g.weights().begin(), g.weights().end()));
+		auto df = dijkstra(gf, 0);
+		auto gl = basic_csr_graph<size_t, long long>(g.offsets(), g.targets(), std::vector<long long>(g.weights().begin(), g.weights().end()));
+		auto dl = dijkstra(gl, 0);
+		for (size_t v = 0; v != 16; ++v) {
+			assert(dd[v] == d[v] && df[v] == d[v] && dl[v] == d[v]);
+		}
+		try {
+			shortest_path(g, 0, 16);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+	}
+	{
+		const auto big = std::numeric_limits<int>::max() - 5;
+		auto edges = std::vector<csr_graph::edge_t>{
+			std::make_tuple(big, 0, 1), std::make_tuple(10, 1, 2), std::make_tuple(1, 2, 3), std::make_tuple(3, 0, 4),
+		};
+		auto g = csr_graph::from_edges(6, edges);
+		auto ans = std::vector<int>{ 0, big, std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), 3, std::numeric_limits<int>::max() };
+		assert(dijkstra(g, 0) == ans);
+		assert(dijkstra<radix_heap>(g, 0) == ans);
+		assert(dijkstra<indexed_dary_heap<>>(g, 0) == ans);
+		assert(dijkstra<pairing_heap>(g, 0) == ans);
+		assert(shortest_path(g, g.reverse(), 0, 3).distance == std::numeric_limits<int>::max());
+		auto m = std::vector<std::vector<std::pair<size_t, int>>>(6);
+		for (auto const& e : edges) {
+			m[std::get<1>(e)].emplace_back(std::get<2>(e), std::get<0>(e));
+		}
+		assert(dijkstra(m, 0) == ans);
+		assert(delta_stepping(m, 0) == ans);
+		using graph64 = basic_csr_graph<std::uint32_t, std::int64_t>;
+		auto l = dijkstra(graph64::from_edges(6, {
+			std::make_tuple(std::int64_t(3000000000), 0, 1), std::make_tuple(std::int64_t(3000000000), 1, 2),
+			std::make_tuple(std::numeric_limits<std::int64_t>::max() - 1, 2, 3),
+		}), 0);
+		assert(l[2] == 6000000000 && l[3] == path_weight<std::int64_t>::unreachable() && l[5] == path_weight<std::int64_t>::unreachable());
+		auto f = dijkstra(basic_csr_graph<std::uint32_t, double>::from_edges(3, { std::make_tuple(0.5, 0, 1) }), 0);
+		assert(f[1] == 0.5 && f[2] == path_weight<double>::unreachable() && std::isinf(f[2]));
+	}
+	{
+		auto keys = std::vector<int>{ 5, 3, 9, 3, 0, 7, 1, 12, 8 };
+		auto sorted = keys;
+		std::sort(sorted.begin(), sorted.end());
+		auto lazy = lazy_binary_heap(keys.size());
+		auto radix = radix_heap(keys.size());
+		auto dary = indexed_dary_heap<4>(keys.size());
+		auto pairing = pairing_heap(keys.size());
+		for (size_t i = 0; i != keys.size(); ++i) {
+			lazy.push(i, keys[i]);
+			radix.push(i, keys[i]);
+			dary.push(i, keys[i]);
+			pairing.push(i, keys[i]);
+		}
+		dary.push(2, 2);
+		dary.push(2, 10);
+		pairing.push(2, 2);
+		pairing.push(2, 10);
+		pairing.push(7, 4);
+		auto psorted = std::vector<int>();
+		while (!pairing.empty()) {
+			psorted.push_back(pairing.pop().first);
+		}
+		assert((psorted == std::vector<int>{ 0, 1, 2, 3, 3, 4, 5, 7, 8 }));
+		sorted.erase(std::find(sorted.begin(), sorted.end(), 9));
+		sorted.insert(std::upper_bound(sorted.begin(), sorted.end(), 2), 2);
+		for (auto k : sorted) {
+			assert(dary.pop().first == k);
+		}
+		assert(dary.empty());
+		auto last = -1;
+		auto n = keys.size();
+		keys.push_back(20);
+		for (size_t i = 0; i != n; ++i) {
+			auto a = lazy.pop();
+			auto b = radix.pop();
+			assert(a.first == b.first && keys[a.second] == a.first && keys[b.second] == b.first);
+			assert(a.first >= last);
+			last = a.first;
+			if (i == 3) {
+				radix.push(n, 20);
+				lazy.push(n, 20);
+			}
+		}
+		assert(radix.pop().first == 20 && lazy.pop().first == 20);
+		assert(lazy.empty() && radix.empty());
+	}
+	{
+		auto edges = std::vector<csr_graph::edge_t>{
+			std::make_tuple(2, 0, 1), std::make_tuple(3, 0, 2), std::make_tuple(4, 1, 3), std::make_tuple(2, 1, 4),
+			std::make_tuple(2, 2, 3), std::make_tuple(2, 2, 4), std::make_tuple(7, 2, 5), std::make_tuple(3, 3, 5),
+			std::make_tuple(4, 4, 5),
+		};
+		auto g = csr_graph32::from_edges(6, edges, true);
+		assert(g.vertices() == 6);
+		assert(g.edges() == 18);
+		assert(g.degree(2) == 4);
+		assert(g.offsets()[1] == 2);
+		assert(g.targets()[0] == 1 && g.weights()[0] == 2);
+		auto ans = std::vector<int>{ 0, 2, 3, 5, 4, 8 };
+		assert(dijkstra(g, 0) == ans);
+		auto h = csr_graph(g.offsets(), std::vector<size_t>(g.targets().begin(), g.targets().end()), g.weights());
+		assert(dijkstra(h, 0) == ans);
+		try {
+			csr_graph::from_edges(6, { std::make_tuple(1, 0, 6) });
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+		try {
+			csr_graph({ 0, 1 }, { 0, 0 }, { 1, 1 });
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+		assert(csr_graph().vertices() == 0);
 	}
 #ifdef Use_Wcout
 	std::wcout << L"Dijkstra 测试完成" << std::endl;
@@ -420,6 +860,128 @@ R"(
 			s.insert(std::get<2>(i));
 		});
 		assert(s.size() == 6);
+		auto g = csr_graph32::from_matrix(map);
+		assert(g.edges() == map.size());
+		auto x = kruskal(g);
+		assert(std::equal(x.begin(), x.end(), ret.begin()));
+		auto lower = sparse_matrix2d<int, 6, 6>({
+			{ 0, 0, 0, 0, 0, 0 },
+			{ 2, 0, 0, 0, 0, 0 },
+			{ 3, 0, 0, 0, 0, 0 },
+			{ 0, 4, 2, 0, 0, 0 },
+			{ 0, 2, 2, 0, 0, 0 },
+			{ 0, 0, 7, 3, 4, 0 },
+		});
+		auto lret = kruskal(lower);
+		assert(std::equal(lret.begin(), lret.end(), ret.begin()));
+		for (auto const& e : lret) {
+			assert(std::get<1>(e) < std::get<2>(e));
+		}
+	}
+	{
+		auto g = std::mt19937(11);
+		auto m = std::vector<std::vector<std::pair<size_t, int>>>(2000);
+		auto edges = std::vector<csr_graph::edge_t>();
+		for (size_t i = 1; i != m.size(); ++i) {
+			for (auto k = 0; k != 3; ++k) {
+				auto j = g() % i;
+				auto w = static_cast<int>(g() % 100);
+				m[i].emplace_back(j, w);
+				m[j].emplace_back(i, w);
+				edges.emplace_back(w, i, j);
+			}
+		}
+		auto sum = [](std::vector<std::tuple<int, size_t, size_t>> const& t) {
+			return std::accumulate(t.begin(), t.end(), 0, [](auto i, auto j) { return i + std::get<0>(j); });
+		};
+		auto ret = kruskal(m);
+		auto x = kruskal(csr_graph::from_edges(m.size(), edges, true));
+		assert(x.size() == m.size() - 1);
+		assert(sum(x) == sum(ret));
+		assert(kruskal(csr_graph32::from_edges(m.size(), edges, true)) == x);
+		assert(filter_kruskal(csr_graph::from_edges(m.size(), edges, true)) == x);
+		assert(filter_kruskal(csr_graph32::from_edges(m.size(), edges, true), 3) == x);
+		assert(boruvka(csr_graph::from_edges(m.size(), edges, true)) == x);
+		assert(boruvka(csr_graph32::from_edges(m.size(), edges, true), 3) == x);
+	}
+	{
+		auto g = std::mt19937(17);
+		const size_t n = 3000;
+		for (auto range : { 1000, 1 }) {
+			auto edges = std::vector<csr_graph::edge_t>();
+			for (size_t k = 0; k != 20 * n; ++k) {
+				auto u = g() % (n - 100);
+				auto v = g() % (n - 100);
+				if (u != v) {
+					edges.emplace_back(static_cast<int>(g() % range), u, v);
+				}
+			}
+			auto csr = csr_graph32::from_edges(n, edges, true);
+			auto x = kruskal(csr);
+			assert(x.size() < n - 100);
+			assert(std::is_sorted(x.begin(), x.end()));
+			for (auto threads : { 1, 2, 4 }) {
+				assert(filter_kruskal(csr, threads) == x);
+				assert(boruvka(csr, threads) == x);
+			}
+		}
+		assert(filter_kruskal(csr_graph()).empty());
+		assert(boruvka(csr_graph()).empty());
+		auto v = std::vector<int>(50000);
+		for (auto& x : v) {
+			x = static_cast<int>(g() % 1000);
+		}
+		auto sorted = v;
+		std::sort(sorted.begin(), sorted.end());
+		auto out = std::vector<int>(v.size());
+		auto even = parallel_partition_copy(v.begin(), v.end(), out.begin(), [](int x) { return x % 2 == 0; }, 3);
+		auto p = v;
+		assert(std::stable_partition(p.begin(), p.end(), [](int x) { return x % 2 == 0; }) - p.begin() == static_cast<std::ptrdiff_t>(even));
+		assert(out == p);
+		std::fill(out.begin(), out.end(), -1);
+		assert(parallel_copy_if(v.begin(), v.end(), out.begin(), [](int x) { return x % 2 == 0; }, 5) == even);
+		assert(std::equal(p.begin(), p.begin() + static_cast<std::ptrdiff_t>(even), out.begin()) && out[even] == -1);
+		for (auto threads : { 1, 3, 8 }) {
+			auto w = v;
+			parallel_sort(w.begin(), w.end(), std::less<>(), threads);
+			assert(w == sorted);
+		}
+	}
+	{
+		auto ds = disjoint_set<std::uint32_t>(10);
+		assert(ds.sets() == 10 && ds.size() == 10);
+		assert(ds.unite(0, 1) && ds.unite(2, 3) && ds.unite(1, 3));
+		assert(!ds.unite(0, 2) && ds.same(0, 3) && !ds.same(0, 4));
+		assert(ds.sets() == 7);
+		for (std::uint32_t i = 5; i != 9; ++i) {
+			ds.unite(i, i + 1);
+		}
+		assert(ds.sets() == 3 && ds.same(5, 9));
+		auto const& cds = ds;
+		assert(cds.find(9) == cds.find(6) && cds.find(9) != cds.find(4));
+
+		auto g = std::mt19937(19);
+		const size_t n = 20000;
+		auto pairs = std::vector<std::pair<size_t, size_t>>(n);
+		for (auto& p : pairs) {
+			p = std::make_pair(g() % n, g() % n);
+		}
+		auto seq = disjoint_set<>(n);
+		for (auto const& p : pairs) {
+			seq.unite(p.first, p.second);
+		}
+		auto par = concurrent_disjoint_set<>(n);
+		auto merged = std::atomic<size_t>(0);
+		parallel_for(pairs.size(), 4, [&](size_t, size_t b, size_t e) {
+			for (auto i = b; i != e; ++i) {
+				merged += par.unite(pairs[i].first, pairs[i].second);
+			}
+		});
+		assert(par.size() == n && n - merged == seq.sets());
+		for (size_t i = 0; i != n; ++i) {
+			assert(par.same(pairs[i].first, pairs[i].second));
+			assert(par.same(i, (i * 7919) % n) == seq.same(i, (i * 7919) % n));
+		}
 	}
 #ifdef Use_Wcout
 	std::wcout << L"Kruskal 测试完成" << std::endl;
@@ -782,5 +1344,757 @@ R"(
 	//++End AVL test
 #endif
 
+#ifndef MatrixMarket_disabled
+	//++Start MatrixMarket test
+	{
+		auto mat = sparse_matrix2d<int, 3, 4>({ { 1, 0, 0, -12 },{ 0, 0, 0, 0 },{ 0, 305, 7, 0 } });
+		std::stringstream ss;
+		matrix_market::write(ss, mat);
+		assert(ss.str() == "%%MatrixMarket matrix coordinate integer general\n3 4 4\n1 1 1\n1 4 -12\n3 2 305\n3 3 7\n");
+
+		auto mat2 = matrix_market::read<int, 3, 4>(ss);
+		assert(mat2.size() == 4);
+		std::stringstream ss1, ss2;
+		ss1 << mat;
+		ss2 << mat2;
+		assert(ss1.str() == ss2.str());
+		assert(mat2.row(2).size() == 2);
+
+		auto big = sparse_matrix2d<long long, 1, 2>();
+		big.set(std::numeric_limits<long long>::min(), 0, 0);
+		big.set(std::numeric_limits<long long>::max(), 0, 1);
+		std::stringstream ssb;
+		matrix_market::write(ssb, big);
+		assert(ssb.str() == "%%MatrixMarket matrix coordinate integer general\n1 2 2\n1 1 -9223372036854775808\n1 2 9223372036854775807\n");
+
+		std::stringstream sym(
+R"(%%MatrixMarket matrix coordinate real symmetric
+% comment line
+%
+  3 3 5
+1 1 2.5
+2 1 -1e-2
+3 2 .5E+1
+3 3 1
+3 3 -1
+)");
+		auto mat3 = matrix_market::read<double, 4, 4>(sym);
+		assert(mat3.size() == 5);
+		assert(mat3.get(0, 0) == 2.5);
+		assert(mat3.get(0, 1) == -0.01);
+		assert(mat3.get(1, 0) == -0.01);
+		assert(mat3.get(2, 1) == 5.0);
+		assert(mat3.get(1, 2) == 5.0);
+		assert(mat3.get(2, 2) == 0.0);
+
+		std::stringstream pattern("%%MatrixMarket matrix coordinate pattern skew-symmetric\n2 2 1\n2 1\n");
+		auto mat4 = matrix_market::read<int, 2, 2>(pattern);
+		assert((mat4.get<1, 0>() == 1));
+		assert((mat4.get<0, 1>() == -1));
+
+		std::stringstream ss3, ss4;
+		matrix_market::write(ss3, mat3);
+		auto mat5 = matrix_market::read<double, 4, 4>(ss3);
+		matrix_market::write(ss4, mat5);
+		assert(ss3.str() == ss4.str());
+
+		try {
+			std::stringstream large("%%MatrixMarket matrix coordinate integer general\n5 2 0\n");
+			matrix_market::read<int, 4, 4>(large);
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+
+		auto unsigned_ok = std::stringstream("%%MatrixMarket matrix coordinate integer general\n2 2 2\n1 1 +7\n2 2 4000000000\n");
+		auto um = matrix_market::read<unsigned int, 2, 2>(unsigned_ok);
+		assert(um.get(0, 0) == 7 && um.get(1, 1) == 4000000000u);
+		for (auto text : {
+			"%%MatrixMarket matrix coordinate integer general\n2 2 1\n1 2 -3\n",
+			"%%MatrixMarket matrix coordinate real general\n2 2 1\n1 2 -0.5\n",
+			"%%MatrixMarket matrix coordinate integer skew-symmetric\n2 2 1\n2 1 3\n",
+		}) {
+			try {
+				std::stringstream negative(text);
+				matrix_market::read<unsigned int, 2, 2>(negative);
+				throw std::runtime_error("str_exception expected");
+			}
+			catch (str_exception& e) {
+				assert(std::wstring(e.error) == L"无符号类型不能为负数");
+			}
+		}
+
+		try {
+			std::stringstream array("%%MatrixMarket matrix array real general\n2 2\n1\n2\n3\n4\n");
+			matrix_market::read<double, 2, 2>(array);
+			throw std::runtime_error("str_exception expected");
+		}
+		catch (str_exception& e) {
+			assert(std::wstring(e.error) == L"错误的矩阵头");
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"MatrixMarket 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "MatrixMarket test complete" << std::endl;
+#endif //Use_Wcout
+	//++End MatrixMarket test
+#endif
+
+#ifndef CsrMatrix_disabled
+	//++Start CsrMatrix test
+	{
+		auto mat = sparse_matrix2d<int, 2, 3>({ { 1,1,0 },{ 0,0,4 } });
+		auto mat2 = sparse_matrix2d<int, 3, 2>({ { 4,0 },{ 1,2 },{ 0,3 } });
+		auto csr = csr_matrix<int, 2, 3>(mat);
+		auto csr2 = csr_matrix<int, 3, 2>(mat2);
+		assert(csr.size() == 3);
+		assert((csr.row_ptr() == std::vector<size_t>{ 0, 2, 3 }));
+		assert(csr.get(1, 2) == 4);
+		assert(csr.get(1, 1) == 0);
+
+		auto y = csr.spmv(std::vector<int>{ 1, 2, 3 });
+		assert((y == std::vector<int>{ 3, 12 }));
+
+		auto csc = csr.Rev();
+		assert((csc.row_ptr() == std::vector<size_t>{ 0, 1, 2, 3 }));
+		assert((csc.col_idx() == std::vector<size_t>{ 0, 0, 1 }));
+		std::stringstream ss3, ss4;
+		ss3 << csc.to_sparse();
+		ss4 << csr_matrix<int, 3, 2>(mat2).Rev(2).Rev(2).Rev(2).to_sparse();
+		assert(ss3.str() == "1 0\n1 0\n0 4\n");
+		assert(ss4.str() == "4 1 0\n0 2 3\n");
+
+		auto prod = csr.Mul(csr2);
+		assert(prod.size() == 3);
+		std::stringstream ss;
+		ss << prod.to_sparse();
+		assert(ss.str() == "5 2\n0 12\n");
+
+		auto graph = csr_matrix<double, 3, 3>(sparse_matrix2d<double, 3, 3>({ { 0,2,5 },{ 0,0,1 },{ 0,0,0 } }));
+		auto inf = min_plus<double>::zero();
+		auto dist = graph.spmv<min_plus<double>>(std::vector<double>{ inf, inf, 0 });
+		assert((dist == std::vector<double>{ 5, 1, inf }));
+		auto dist2 = std::vector<double>(3);
+		graph.spmv<min_plus<double>>(dist.data(), dist2.data(), 2);
+		assert((dist2 == std::vector<double>{ 3, inf, inf }));
+		auto paths = graph.Mul<min_plus<double>>(graph);
+		assert(paths.size() == 1);
+		assert(paths.get(0, 2) == 3);
+		assert(paths.get<min_plus<double>>(0, 2) == 3);
+		assert(paths.get<min_plus<double>>(1, 0) == inf);
+
+		try {
+			csr.get(2, 0);
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+
+		try {
+			csr.spmv(std::vector<int>{ 1, 2 });
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Vector size check failed");
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"CsrMatrix 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "CsrMatrix test complete" << std::endl;
+#endif //Use_Wcout
+	//++End CsrMatrix test
+#endif
+
+#if !defined(BsrMatrix_disabled) && !defined(CsrMatrix_disabled)
+	//++Start BsrMatrix test
+	{
+		auto mat = sparse_matrix2d<double, 8, 8>({
+			{ 1, 2, 0, 0, 0, 0, 0, 1 },
+			{ 3, 4, 0, 0, 0, 0, 0, 0 },
+			{ 0, 0, 5, 0, 0, 0, 0, 0 },
+			{ 0, 0, 0, 6, 0, 0, 0, 0 },
+			{ 0, 0, 0, 0, 0, 0, 0, 0 },
+			{ 0, 0, 0, 0, 0, 0, 0, 0 },
+			{ 0, 0, 0, 0, 0, 7, 0, 0 },
+			{ 2, 0, 0, 0, 0, 0, 8, 0 },
+		});
+		auto bsr = bsr_matrix<double, 8, 8, 4>(mat);
+		auto csr = csr_matrix<double, 8, 8>(mat);
+		assert(bsr.blocks() == 4);
+		assert(bsr.get(1, 0) == 3);
+		assert(bsr.get(7, 6) == 8);
+		assert(bsr.get(4, 4) == 0);
+
+		auto x = std::vector<double>{ 1, 2, 3, 4, 5, 6, 7, 8 };
+		assert(bsr.spmv(x) == csr.spmv(x));
+
+		std::stringstream ss1, ss2, ss3, ss4;
+		ss1 << csr.Mul(csr).to_sparse();
+		ss2 << bsr.Mul(bsr).to_sparse();
+		ss3 << bsr.to_sparse();
+		ss4 << mat;
+		assert(ss1.str() == ss2.str());
+		assert(ss3.str() == ss4.str());
+
+		auto bsr8 = bsr_matrix<double, 8, 8, 8>(mat);
+		assert(bsr8.blocks() == 1);
+		assert(bsr8.spmv(x) == csr.spmv(x));
+
+		auto imat = sparse_matrix2d<int, 4, 6>({ { 1,0,0,0,2,0 },{ 0,0,0,0,0,3 },{ 0,0,0,0,0,0 },{ 0,4,0,0,0,0 } });
+		auto ibsr = bsr_matrix<int, 4, 6, 2>(imat);
+		assert(ibsr.blocks() == 3);
+		assert((ibsr.spmv(std::vector<int>{ 1, 1, 1, 1, 1, 1 }) == std::vector<int>{ 3, 3, 0, 4 }));
+	}
+#ifdef Use_Wcout
+	std::wcout << L"BsrMatrix 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "BsrMatrix test complete" << std::endl;
+#endif //Use_Wcout
+	//++End BsrMatrix test
+#endif
+
+#ifndef SparseSolver_disabled
+	//++Start SparseSolver test
+	{
+		auto a = sparse_matrix2d<double, 4, 4>({
+			{ 4, -1, 0, 0 },
+			{ -1, 4, -1, 0 },
+			{ 0, -1, 4, -1 },
+			{ 0, 0, -1, 3 },
+		});
+		auto b = std::vector<double>{ 1, 2, 0, 1 };
+		auto cg = conjugate_gradient(a, b);
+		assert(cg.converged);
+		assert(cg.iterations <= 4);
+		auto ax = csr_matrix<double, 4, 4>(a).spmv(cg.x);
+		for (size_t i = 0; i != 4; ++i) {
+			assert(fabs(ax[i] - b[i]) < 1e-9);
+		}
+
+		auto cg2 = conjugate_gradient(csr_matrix<double, 4, 4>(a), b, 1e-12, 100, 3);
+		for (size_t i = 0; i != 4; ++i) {
+			assert(fabs(cg2.x[i] - cg.x[i]) < 1e-9);
+		}
+
+		auto cg3 = conjugate_gradient(a, b, 1e-12, 1);
+		assert(!cg3.converged && cg3.iterations == 1);
+
+		auto d = sparse_matrix2d<double, 3, 3>({ { 2, 1, 0 },{ 1, 2, 0 },{ 0, 0, 1 } });
+		auto pi = power_iteration(d, 1e-12, 1000, 2);
+		assert(pi.converged);
+		assert(fabs(pi.value - 3.0) < 1e-9);
+		assert(fabs(pi.x[0] - pi.x[1]) < 1e-6 && fabs(pi.x[2]) < 1e-6);
+
+		auto lap = sparse_matrix2d<double, 200, 200>();
+		for (size_t i = 0; i != 200; ++i) {
+			lap.set(2.5, i, i);
+			if (i != 0) {
+				lap.set(-1.0, i, i - 1);
+				lap.set(-1.0, i - 1, i);
+			}
+		}
+		auto rhs = std::vector<double>(200);
+		for (size_t i = 0; i != 200; ++i) {
+			rhs[i] = static_cast<double>(i % 7);
+		}
+		auto lap_csr = csr_matrix<double, 200, 200>(lap);
+		auto cg4 = conjugate_gradient(lap_csr, rhs, 1e-12, 1000, 4);
+		auto cg1 = conjugate_gradient(lap_csr, rhs, 1e-12, 1000, 1);
+		assert(cg4.converged && cg1.converged);
+		auto lx = lap_csr.spmv(cg4.x);
+		for (size_t i = 0; i != 200; ++i) {
+			assert(fabs(lx[i] - rhs[i]) < 1e-9);
+			assert(fabs(cg4.x[i] - cg1.x[i]) < 1e-9);
+		}
+		auto pi4 = power_iteration(lap_csr, 1e-9, 100000, 4);
+		auto pi1 = power_iteration(lap_csr, 1e-9, 100000, 1);
+		assert(pi4.converged && pi1.converged);
+		assert(fabs(pi4.value - pi1.value) < 1e-9);
+
+		try {
+			conjugate_gradient(a, std::vector<double>{ 1, 2 });
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Vector size check failed");
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"SparseSolver 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "SparseSolver test complete" << std::endl;
+#endif //Use_Wcout
+	//++End SparseSolver test
+#endif
+
+#ifndef CsrFile_disabled
+	//++Start CsrFile test
+	{
+		auto mat = sparse_matrix2d<double, 4, 3>({ { 1,0,2 },{ 0,0,0 },{ 0,3,0 },{ 4,0,5 } });
+		auto mat2 = sparse_matrix2d<double, 3, 2>({ { 1,0 },{ 0,2 },{ 1,1 } });
+		auto csr = csr_matrix<double, 4, 3>(mat);
+		auto csr2 = csr_matrix<double, 3, 2>(mat2);
+		csr_file::write("DsExp_csr_a.bin", mat);
+		csr_file::write("DsExp_csr_b.bin", csr2);
+		{
+			auto a = csr_file::map<double, 4, 3>("DsExp_csr_a.bin");
+			auto b = csr_file::map<double, 3, 2>("DsExp_csr_b.bin");
+			assert(a.size() == 5);
+			assert(a.get(3, 2) == 5);
+			assert(a.get(1, 1) == 0);
+			assert(a.get<min_plus<double>>(1, 1) == min_plus<double>::zero());
+			assert(a.row_ptr()[2] == 2);
+
+			auto x = std::vector<double>{ 1, 2, 3 };
+			assert(a.spmv(x) == csr.spmv(x));
+			auto y = std::vector<double>(4);
+			a.spmv(x.data(), y.data(), 1);
+			assert(y == csr.spmv(x));
+
+			a.Mul(b, "DsExp_csr_c.bin", 1);
+			auto c = csr_file::map<double, 4, 2>("DsExp_csr_c.bin");
+			auto prod = csr.Mul(csr2);
+			std::stringstream ss1, ss2;
+			ss1 << c.load().to_sparse();
+			ss2 << prod.to_sparse();
+			assert(ss1.str() == ss2.str());
+			assert(c.size() == prod.size());
+
+			try {
+				a.get(4, 0);
+				throw std::runtime_error("std::out_of_range expected");
+			}
+			catch (std::out_of_range& e) {
+				assert(std::string(e.what()) == "Matrix bound check failed");
+			}
+
+			try {
+				csr_file::map<double, 3, 4>("DsExp_csr_a.bin");
+				throw std::runtime_error("str_exception expected");
+			}
+			catch (str_exception& e) {
+				assert(e.start == "DsExp_csr_a.bin");
+			}
+
+			try {
+				csr_file::map<float, 4, 3>("DsExp_csr_a.bin");
+				throw std::runtime_error("str_exception expected");
+			}
+			catch (str_exception& e) {
+				assert(e.start == "DsExp_csr_a.bin");
+			}
+		}
+		{
+			auto in = std::ifstream("DsExp_csr_a.bin", std::ios::binary);
+			auto orig = std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+			csr_file_header h;
+			std::memcpy(&h, orig.data(), sizeof(h));
+			auto patch = [&orig](size_t off, uint64_t x) {
+				auto bad = orig;
+				std::memcpy(&bad[off], &x, sizeof(x));
+				return bad;
+			};
+			auto cases = std::vector<std::string>{
+				patch(static_cast<size_t>(h.col_off + 4 * sizeof(uint64_t)), 3),
+				patch(static_cast<size_t>(h.ptr_off + 2 * sizeof(uint64_t)), 1),
+				patch(static_cast<size_t>(h.ptr_off + 4 * sizeof(uint64_t)), 4),
+				patch(offsetof(csr_file_header, nnz), (uint64_t(1) << 61) + 5),
+				patch(offsetof(csr_file_header, val_off), ~uint64_t(7)),
+			};
+			for (auto const& bad : cases) {
+				{
+					auto out = std::ofstream("DsExp_csr_bad.bin", std::ios::binary);
+					out << bad;
+				}
+				try {
+					csr_file::map<double, 4, 3>("DsExp_csr_bad.bin");
+					throw std::runtime_error("str_exception expected");
+				}
+				catch (str_exception& e) {
+					assert(e.start == "DsExp_csr_bad.bin");
+				}
+			}
+		}
+		std::remove("DsExp_csr_a.bin");
+		std::remove("DsExp_csr_b.bin");
+		std::remove("DsExp_csr_c.bin");
+		std::remove("DsExp_csr_bad.bin");
+	}
+#ifdef Use_Wcout
+	std::wcout << L"CsrFile 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "CsrFile test complete" << std::endl;
+#endif //Use_Wcout
+	//++End CsrFile test
+#endif
+
+#ifndef SmallMatrix_disabled
+	//++Start SmallMatrix test
+	{
+		constexpr auto mat = small_matrix2d<int, 2, 3>({ { 1,1,0 },{ 0,0,4 } });
+		constexpr auto mat2 = small_matrix2d<int, 3, 1>({ { 4 },{ 1 },{ 2 } });
+		constexpr auto mat3 = mat * mat2;
+		static_assert(mat3.get<0, 0>() == 5, "constexpr Mul failed");
+		static_assert(mat3.get<1, 0>() == 8, "constexpr Mul failed");
+		static_assert(mat.Rev().get<2, 1>() == 4, "constexpr Rev failed");
+		static_assert((mat + mat).get<1, 2>() == 8, "constexpr Add failed");
+		static_assert((mat - mat).size() == 0, "constexpr Sub failed");
+		static_assert(mat.size() == 3 && mat.row_size(0) == 2, "constexpr size failed");
+		static_assert(std::is_same<matrix2d_t<int, 4, 4>, small_matrix2d<int, 4, 4>>::value, "small matrix not selected");
+		static_assert(std::is_same<matrix2d_t<int, 16, 16>, sparse_matrix2d<int, 16, 16>>::value, "sparse matrix not selected");
+
+		auto sparse = sparse_matrix2d<int, 2, 3>({ { 1,1,0 },{ 0,0,4 } });
+		std::stringstream ss1, ss2;
+		ss1 << (sparse * sparse_matrix2d<int, 3, 2>({ { 1,0 },{ 2,3 },{ 0,1 } }));
+		ss2 << mat.Mul(small_matrix2d<int, 3, 2>({ { 1,0 },{ 2,3 },{ 0,1 } }));
+		assert(ss1.str() == ss2.str());
+		assert((small_matrix2d<int, 2, 3>(sparse).Axpby(2, mat, -1).get(1, 2) == 4));
+
+		auto mat4 = small_matrix2d<int, 4, 4>();
+		mat4.set(0, 0, 0);
+		mat4.set<1, 2>(7);
+		int out;
+		assert(mat4.have(0, 0, out) && out == 0);
+		assert((mat4.have<1, 2>(out) && out == 7));
+		assert(!mat4.have(2, 2, out));
+		assert(mat4.row(1).size() == 1 && mat4.row<1>()[0].first == 2);
+		assert(mat4.to_sparse().size() == 2);
+		auto dist = mat4.Mul<min_plus<int>>(mat4);
+		assert(dist.size() == 1 && dist.have(0, 0, out) && out == 0);
+
+		try {
+			mat4.get(4, 0);
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"SmallMatrix 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "SmallMatrix test complete" << std::endl;
+#endif //Use_Wcout
+	//++End SmallMatrix test
+#endif
+
+#ifndef HybridMatrix_disabled
+	//++Start HybridMatrix test
+	{
+		auto mat = sparse_matrix2d<int, 4, 70>();
+		mat.set(1, 0, 0);
+		mat.set(2, 0, 64);
+		mat.set(3, 0, 65);
+		mat.set(4, 0, 69);
+		mat.set(5, 1, 3);
+		mat.set(6, 3, 1);
+		mat.set(7, 3, 2);
+		mat.set(8, 3, 68);
+		auto hyb = hybrid_matrix<int, 4, 70>(mat, 3);
+		assert(hyb.size() == 8);
+		assert(hyb.dense_rows() == 2);
+		assert(hyb.is_dense(0) && !hyb.is_dense(1) && !hyb.is_dense(2) && hyb.is_dense(3));
+		assert(hyb.get(0, 65) == 3 && hyb.get(0, 66) == 0);
+		assert(hyb.get(1, 3) == 5 && hyb.get(1, 4) == 0);
+		assert(hyb.row_size(0) == 4 && hyb.row_size(2) == 0);
+		auto r0 = hyb.row(0);
+		assert(r0.size() == 4 && r0[1].first == 64 && r0[3].second == 4);
+		std::stringstream ss1, ss2;
+		ss1 << hyb.to_sparse();
+		ss2 << mat;
+		assert(ss1.str() == ss2.str());
+
+		auto x = std::vector<int>(70, 1);
+		assert((hyb.spmv(x) == std::vector<int>{ 10, 5, 0, 21 }));
+
+		auto mat2 = sparse_matrix2d<int, 70, 2>();
+		mat2.set(1, 0, 0);
+		mat2.set(2, 64, 1);
+		mat2.set(3, 68, 0);
+		mat2.set(4, 68, 1);
+		auto prod = hyb.Mul(hybrid_matrix<int, 70, 2>(mat2), 2);
+		std::stringstream ss3, ss4;
+		ss3 << prod.to_sparse();
+		ss4 << mat * mat2;
+		assert(ss3.str() == ss4.str());
+		assert(prod.is_dense(0) && !prod.is_dense(1) && prod.is_dense(3));
+		assert((hybrid_matrix<int, 4, 70>(mat).dense_rows() == 0));
+
+		try {
+			hyb.get(4, 0);
+			throw std::runtime_error("std::out_of_range expected");
+		}
+		catch (std::out_of_range& e) {
+			assert(std::string(e.what()) == "Matrix bound check failed");
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"HybridMatrix 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "HybridMatrix test complete" << std::endl;
+#endif //Use_Wcout
+	//++End HybridMatrix test
+#endif
+
+#ifndef ContractionHierarchy_disabled
+	//++Start ContractionHierarchy test
+	{
+		auto map = std::vector<std::vector<std::pair<size_t, int>>>{
+			{ { 1, 2 }, { 2, 3 } },
+			{ { 0, 2 }, { 3, 4 }, { 4, 2 } },
+			{ { 0, 3 }, { 3, 2 }, { 4, 2 }, { 5, 7 } },
+			{ { 1, 4 }, { 2, 2 }, { 5, 3 } },
+			{ { 1, 2 }, { 2, 2 }, { 5, 4 } },
+			{ { 2, 7 }, { 3, 3 }, { 4, 4 } },
+		};
+		auto ch = contraction_hierarchy(map);
+		assert(ch.vertices() == 6);
+		auto ans = std::vector<int>{ 0, 2, 3, 5, 4, 8 };
+		for (size_t t = 0; t != 6; ++t) {
+			auto r = ch.query(0, t);
+			assert(r.distance == ans[t]);
+			assert(r.path.front() == 0 && r.path.back() == t);
+		}
+		try {
+			ch.query(0, 6);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+	}
+	{
+		auto g = std::mt19937(5);
+		const size_t side = 30;
+		auto m = std::vector<std::vector<std::pair<size_t, int>>>(side * side + 10);
+		for (size_t v = 0; v != side * side; ++v) {
+			if (v % side != side - 1) {
+				m[v].emplace_back(v + 1, static_cast<int>(g() % 20 + 1));
+				if (g() % 4 != 0) {
+					m[v + 1].emplace_back(v, static_cast<int>(g() % 20 + 1));
+				}
+			}
+			if (v + side < side * side) {
+				m[v].emplace_back(v + side, static_cast<int>(g() % 20 + 1));
+				m[v + side].emplace_back(v, static_cast<int>(g() % 20 + 1));
+			}
+		}
+		auto ch = contraction_hierarchy(m);
+		auto fw = dijkstra_workspace();
+		auto bw = dijkstra_workspace();
+		for (size_t s = 0; s < m.size(); s += 83) {
+			auto d = dijkstra(m, s);
+			for (size_t t = 0; t < m.size(); t += 7) {
+				auto r = ch.query(s, t, fw, bw);
+				assert(r.distance == d[t]);
+				assert(ch.distance(s, t, fw, bw) == d[t]);
+				if (d[t] == std::numeric_limits<int>::max()) {
+					assert(r.path.empty());
+					continue;
+				}
+				auto len = 0;
+				for (size_t i = 1; i < r.path.size(); ++i) {
+					auto w = std::numeric_limits<int>::max();
+					for (auto const& e : m[r.path[i - 1]]) {
+						if (e.first == r.path[i]) {
+							w = std::min(w, e.second);
+						}
+					}
+					assert(w != std::numeric_limits<int>::max());
+					len += w;
+				}
+				assert(r.path.front() == s && r.path.back() == t && len == d[t]);
+			}
+		}
+		assert(ch.bytes() > 0);
+	}
+#ifdef Use_Wcout
+	std::wcout << L"ContractionHierarchy 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "ContractionHierarchy test complete" << std::endl;
+#endif //Use_Wcout
+	//++End ContractionHierarchy test
+#endif
+
+#ifndef AllPairs_disabled
+	//++Start AllPairs test
+	{
+		auto map = sparse_matrix2d<int, 6, 6>({
+			{ 0, 2, 3, 0, 0, 0 },
+			{ 2, 0, 0, 4, 2, 0 },
+			{ 3, 0, 0, 2, 2, 7 },
+			{ 0, 4, 2, 0, 0, 3 },
+			{ 0, 2, 2, 0, 0, 4 },
+			{ 0, 0, 7, 3, 4, 0 },
+		});
+		for (auto method : { apsp_method::Auto, apsp_method::FloydWarshall, apsp_method::Dijkstra }) {
+			auto d = all_pairs(map, method);
+			assert(d.size() == 36);
+			for (size_t s = 0; s != 6; ++s) {
+				auto ret = dijkstra(map, s);
+				assert(std::equal(ret.begin(), ret.end(), d.begin() + s * 6));
+			}
+		}
+		assert(apsp_select(csr_graph::from_matrix(map)) == apsp_method::FloydWarshall);
+		assert(apsp_select(csr_graph::from_edges(4096, {})) == apsp_method::Dijkstra);
+		auto far = csr_graph::from_edges(2, { csr_graph::edge_t(apsp_infinity, 0, 1) });
+		assert(apsp_select(far) == apsp_method::Dijkstra);
+		assert(all_pairs(far) == (std::vector<int>{ 0, apsp_infinity, std::numeric_limits<int>::max(), 0 }));
+		try {
+			floyd_warshall(std::vector<int>(5), 2);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+		try {
+			floyd_warshall(std::vector<int>{ 0, -1, 1, 0 }, 2);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+	}
+	{
+		auto g = std::mt19937(11);
+		for (auto degree : { 2, 40 }) {
+			const size_t n = 150;
+			auto edges = std::vector<csr_graph::edge_t>();
+			for (size_t u = 0; u != n - 3; ++u) {
+				for (auto k = 0; k != degree; ++k) {
+					edges.emplace_back(static_cast<int>(g() % 1000), u, g() % (n - 3));
+				}
+			}
+			auto csr = csr_graph::from_edges(n, edges);
+			auto ans = std::vector<int>();
+			for (size_t s = 0; s != n; ++s) {
+				auto ret = dijkstra(csr, s);
+				ans.insert(ans.end(), ret.begin(), ret.end());
+			}
+			assert(all_pairs(csr) == ans);
+			assert(all_pairs(csr, apsp_method::Dijkstra, 3) == ans);
+			assert(all_pairs(csr, apsp_method::FloydWarshall, 1) == ans);
+			assert(all_pairs(csr_graph32::from_edges(n, edges), apsp_method::FloydWarshall, 4) == ans);
+			auto d = std::vector<int>(n * n, std::numeric_limits<int>::max());
+			for (auto const& e : edges) {
+				auto& x = d[std::get<1>(e) * n + std::get<2>(e)];
+				x = std::min(x, std::get<0>(e));
+			}
+			assert(floyd_warshall<8>(d, n, 2) == ans);
+			assert(floyd_warshall<12>(d, n) == ans);
+		}
+	}
+#ifdef Use_Wcout
+	std::wcout << L"AllPairs 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "AllPairs test complete" << std::endl;
+#endif //Use_Wcout
+	//++End AllPairs test
+#endif
+
+#ifndef DynamicSssp_disabled
+	//++Start DynamicSssp test
+	{
+		auto map = std::vector<std::vector<std::pair<size_t, int>>>{
+			{ { 1, 2 }, { 2, 3 } },
+			{ { 0, 2 }, { 3, 4 }, { 4, 2 } },
+			{ { 0, 3 }, { 3, 2 }, { 4, 2 }, { 5, 7 } },
+			{ { 1, 4 }, { 2, 2 }, { 5, 3 } },
+			{ { 1, 2 }, { 2, 2 }, { 5, 4 } },
+			{ { 2, 7 }, { 3, 3 }, { 4, 4 } },
+		};
+		auto sp = dynamic_sssp(map, 0);
+		assert(sp.distances() == (std::vector<int>{ 0, 2, 3, 5, 4, 8 }));
+		assert(sp.path(5).front() == 0 && sp.path(5).back() == 5);
+		sp.update(0, 1, 10);
+		assert(sp.weight(0, 1) == 10);
+		assert(sp.distances() == (std::vector<int>{ 0, 7, 3, 5, 5, 8 }));
+		sp.update(0, 5, 1);
+		assert(sp.distances() == (std::vector<int>{ 0, 7, 3, 4, 5, 1 }));
+		assert(sp.erase(0, 5) && !sp.erase(0, 5));
+		assert(sp.weight(0, 5) == std::numeric_limits<int>::max());
+		assert(sp.distances() == (std::vector<int>{ 0, 7, 3, 5, 5, 8 }));
+		assert(sp.erase(0, 1) && sp.erase(0, 2));
+		assert(sp.distance(5) == std::numeric_limits<int>::max());
+		assert(sp.predecessor(5) == 6 && sp.path(5).empty());
+		sp.update(0, 2, 1);
+		assert(sp.distances() == (std::vector<int>{ 0, 5, 1, 3, 3, 6 }));
+		try {
+			sp.update(0, 6, 1);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+		try {
+			sp.update(0, 1, -1);
+			assert(false);
+		}
+		catch (std::out_of_range& e) {}
+	}
+	{
+		auto g = std::mt19937(13);
+		const size_t n = 400;
+		auto m = std::vector<std::vector<std::pair<size_t, int>>>(n);
+		auto edges = std::vector<csr_graph::edge_t>();
+		for (size_t u = 0; u != n; ++u) {
+			for (auto k = 0; k != 3; ++k) {
+				auto v = g() % n;
+				auto w = static_cast<int>(g() % 20 + 1);
+				m[u].emplace_back(v, w);
+				edges.emplace_back(w, u, v);
+			}
+		}
+		auto sp = dynamic_sssp(csr_graph::from_edges(n, edges), 0);
+		assert(sp.distances() == dijkstra(m, 0));
+		assert(dynamic_sssp(m, 0).distances() == sp.distances());
+		auto ref = std::vector<std::vector<std::pair<size_t, int>>>(n);
+		for (size_t u = 0; u != n; ++u) {
+			for (size_t v = 0; v != n; ++v) {
+				if (sp.weight(u, v) != std::numeric_limits<int>::max()) {
+					ref[u].emplace_back(v, sp.weight(u, v));
+				}
+			}
+		}
+		size_t affected = 0;
+		for (auto step = 0; step != 3000; ++step) {
+			auto u = g() % n;
+			if (g() % 3 == 0 && !ref[u].empty()) {
+				auto k = g() % ref[u].size();
+				assert(sp.erase(u, ref[u][k].first));
+				ref[u].erase(ref[u].begin() + static_cast<std::ptrdiff_t>(k));
+			} else {
+				auto v = g() % n;
+				auto w = static_cast<int>(g() % 20);
+				sp.update(u, v, w);
+				auto it = std::find_if(ref[u].begin(), ref[u].end(), [v](std::pair<size_t, int> const& e) { return e.first == v; });
+				if (it == ref[u].end()) {
+					ref[u].emplace_back(v, w);
+				} else {
+					it->second = w;
+				}
+			}
+			affected += sp.last_affected();
+			if (step % 10 == 0) {
+				assert(sp.distances() == dijkstra(ref, 0));
+				for (size_t v = 1; v != n; ++v) {
+					auto p = sp.predecessor(v);
+					if (p == n) {
+						assert(sp.distance(v) == std::numeric_limits<int>::max());
+					} else {
+						assert(sp.distance(v) == sp.distance(p) + sp.weight(p, v));
+					}
+				}
+			}
+		}
+		assert(sp.distances() == dijkstra(ref, 0));
+		assert(affected < 3000 * n / 4);
+		auto t = sp.path(n - 1);
+		assert(t.empty() || (t.front() == 0 && t.back() == n - 1));
+	}
+#ifdef Use_Wcout
+	std::wcout << L"DynamicSssp 测试完成" << std::endl;
+#else //Use_Wcout
+	std::cout << "DynamicSssp test complete" << std::endl;
+#endif //Use_Wcout
+	//++End DynamicSssp test
+#endif
+
 	return 0;
 }
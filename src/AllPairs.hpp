@@ -0,0 +1,279 @@
+#pragma once
+
+#ifndef AllPairs_disabled
+
+#ifndef AllPairs_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "CsrGraph.hpp"
+#include "Dijkstra.h"
+#include "Parallel.hpp"
+#include "SparseMatrix.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// @brief 分块Floyd–Warshall内部使用的无穷大
+/// @details 取int最大值的一半，两个距离相加不会溢出，每次松弛都与不超过它的旧值取min，所有距离始终不超过它
+constexpr int apsp_infinity = std::numeric_limits<int>::max() / 2;
+
+/// @brief 逐个起点dijkstra中每个顶点的代价(出入堆、初始化与输出)，以标量(min, +)次数计
+constexpr size_t apsp_vertex_cost = 192;
+
+/// @brief 逐个起点dijkstra中每条边松弛的代价，以标量(min, +)次数计
+constexpr size_t apsp_edge_cost = 8;
+
+/// @brief 全源最短路的算法选择
+enum class apsp_method
+{
+	/// 按稠密度自动选择
+	Auto,
+
+	/// 分块Floyd–Warshall
+	FloydWarshall,
+
+	/// 逐个起点的dijkstra
+	Dijkstra,
+};
+
+/// @brief BxB距离块上的(min, +)计算核
+/// @details 块为行主序的大矩阵中的子块，行距为ld，通用版本为标量循环
+/// @tparam B 块大小
+template <size_t B, typename = void>
+struct apsp_kernel
+{
+	/// 每条指令处理的元素数
+	static constexpr size_t lanes = 1;
+
+	/// @brief Floyd–Warshall顺序的块更新 c[i][j] = min(c[i][j], a[i][k] + b[k][j])，k为最外层循环
+	/// @details a、b可与c为同一块(对角块与十字块)，要求对角线为0
+	/// @param c 被更新的块
+	/// @param a 左块
+	/// @param b 右块
+	/// @param ld 行距
+	static void closure(int* c, int const* a, int const* b, size_t ld) noexcept
+	{
+		for (size_t k = 0; k != B; ++k) {
+			for (size_t i = 0; i != B; ++i) {
+				auto aik = a[i * ld + k];
+				for (size_t j = 0; j != B; ++j) {
+					c[i * ld + j] = std::min(c[i * ld + j], aik + b[k * ld + j]);
+				}
+			}
+		}
+	}
+
+	/// @brief 块的(min, +)乘积累加 c = min(c, a * b)，a、b不能与c重叠
+	/// @param c 被更新的块
+	/// @param a 左块
+	/// @param b 右块
+	/// @param ld 行距
+	static void minplus(int* c, int const* a, int const* b, size_t ld) noexcept
+	{
+		for (size_t i = 0; i != B; ++i) {
+			for (size_t k = 0; k != B; ++k) {
+				auto aik = a[i * ld + k];
+				for (size_t j = 0; j != B; ++j) {
+					c[i * ld + j] = std::min(c[i * ld + j], aik + b[k * ld + j]);
+				}
+			}
+		}
+	}
+};
+
+#ifdef __AVX2__
+/// @brief int32的AVX2计算核，要求B为8的倍数
+/// @tparam B 块大小
+template <size_t B>
+struct apsp_kernel<B, typename std::enable_if<B % 8 == 0>::type>
+{
+	static constexpr size_t lanes = 8;
+
+	static void closure(int* c, int const* a, int const* b, size_t ld) noexcept
+	{
+		for (size_t k = 0; k != B; ++k) {
+			for (size_t i = 0; i != B; ++i) {
+				auto aik = _mm256_set1_epi32(a[i * ld + k]);
+				for (size_t j = 0; j != B; j += 8) {
+					auto bk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + k * ld + j));
+					auto ci = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(c + i * ld + j));
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i * ld + j), _mm256_min_epi32(ci, _mm256_add_epi32(aik, bk)));
+				}
+			}
+		}
+	}
+
+	static void minplus(int* c, int const* a, int const* b, size_t ld) noexcept
+	{
+		for (size_t i = 0; i != B; ++i) {
+			__m256i s[B / 8];
+			for (size_t r = 0; r != B / 8; ++r) {
+				s[r] = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(c + i * ld + 8 * r));
+			}
+			for (size_t k = 0; k != B; ++k) {
+				auto aik = _mm256_set1_epi32(a[i * ld + k]);
+				for (size_t r = 0; r != B / 8; ++r) {
+					auto bk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(b + k * ld + 8 * r));
+					s[r] = _mm256_min_epi32(s[r], _mm256_add_epi32(aik, bk));
+				}
+			}
+			for (size_t r = 0; r != B / 8; ++r) {
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(c + i * ld + 8 * r), s[r]);
+			}
+		}
+	}
+};
+#endif
+
+/// @brief 分块Floyd–Warshall
+/// @details
+/// 距离矩阵补齐为B的倍数后按k块分三步：对角块自身闭包、同行同列的十字块、其余块的(min, +)乘积，
+/// 第二、三步的块互不依赖，按块行分给多个线程
+/// @return n*n的行主序距离矩阵，不可达为int最大值
+/// @param d n*n的行主序邻接矩阵，无边为int最大值，边权需非负，最短距离需小于apsp_infinity
+/// @param n 顶点数
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam B 块大小
+template <size_t B = 64>
+std::vector<int> floyd_warshall(std::vector<int> const& d, size_t n, size_t threads = 0)
+{
+	if (d.size() != n * n) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto tiles = (n + B - 1) / B;
+	auto ld = tiles * B;
+	auto m = std::vector<int>(ld * ld, apsp_infinity);
+	for (size_t i = 0; i != ld; ++i) {
+		m[i * ld + i] = 0;
+	}
+	for (size_t i = 0; i != n; ++i) {
+		for (size_t j = 0; j != n; ++j) {
+			auto w = d[i * n + j];
+			if (w < 0) {
+				throw std::out_of_range("Weight bound check failed");
+			}
+			if (i != j) {
+				m[i * ld + j] = std::min(w, apsp_infinity);
+			}
+		}
+	}
+	auto tile = [&m, ld](size_t i, size_t j) { return m.data() + i * B * ld + j * B; };
+	for (size_t k = 0; k != tiles; ++k) {
+		auto kk = tile(k, k);
+		apsp_kernel<B>::closure(kk, kk, kk, ld);
+		parallel_for(2 * tiles, threads, [&](size_t, size_t b, size_t e) {
+			for (auto x = b; x != e; ++x) {
+				auto t = x % tiles;
+				if (t == k) {
+					continue;
+				}
+				if (x < tiles) {
+					apsp_kernel<B>::closure(tile(k, t), kk, tile(k, t), ld);
+				} else {
+					apsp_kernel<B>::closure(tile(t, k), tile(t, k), kk, ld);
+				}
+			}
+		});
+		parallel_for(tiles, threads, [&](size_t, size_t b, size_t e) {
+			for (auto i = b; i != e; ++i) {
+				if (i == k) {
+					continue;
+				}
+				for (size_t j = 0; j != tiles; ++j) {
+					if (j != k) {
+						apsp_kernel<B>::minplus(tile(i, j), tile(i, k), tile(k, j), ld);
+					}
+				}
+			}
+		});
+	}
+	auto ret = std::vector<int>(n * n);
+	for (size_t i = 0; i != n; ++i) {
+		for (size_t j = 0; j != n; ++j) {
+			auto x = m[i * ld + j];
+			ret[i * n + j] = x >= apsp_infinity ? std::numeric_limits<int>::max() : x;
+		}
+	}
+	return ret;
+}
+
+/// @brief 按代价估计选择全源最短路算法
+/// @details
+/// 分块Floyd–Warshall的代价为n^3 / lanes，逐个起点dijkstra为n * (n * apsp_vertex_cost + E * apsp_edge_cost)，
+/// 取较小者，启用AVX2时约在E > n^2 / 64 - 24n处交叉；
+/// 最长可能的路径(n - 1条最大边)不小于apsp_infinity时总是选择dijkstra
+/// @return FloydWarshall或Dijkstra
+/// @param g 图
+/// @tparam Id 顶点编号类型
+template <typename Id>
+apsp_method apsp_select(basic_csr_graph<Id, int> const& g)
+{
+	auto n = g.vertices();
+	auto max_w = g.weights().empty() ? 0 : *std::max_element(g.weights().begin(), g.weights().end());
+	if (n > 1 && static_cast<long long>(max_w) * static_cast<long long>(n - 1) >= apsp_infinity) {
+		return apsp_method::Dijkstra;
+	}
+	auto fw = n * n;
+	auto dj = apsp_kernel<64>::lanes * (n * apsp_vertex_cost + g.edges() * apsp_edge_cost);
+	return fw <= dj ? apsp_method::FloydWarshall : apsp_method::Dijkstra;
+}
+
+/// @brief 全源最短路
+/// @return n*n的行主序距离矩阵，不可达为int最大值
+/// @param g 图，边权需非负
+/// @param method 算法，Auto时由apsp_select选择
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam Id 顶点编号类型
+template <typename Id>
+std::vector<int> all_pairs(basic_csr_graph<Id, int> const& g, apsp_method method = apsp_method::Auto, size_t threads = 0)
+{
+	auto n = g.vertices();
+	if (method == apsp_method::Auto) {
+		method = apsp_select(g);
+	}
+	if (method == apsp_method::FloydWarshall) {
+		auto d = std::vector<int>(n * n, std::numeric_limits<int>::max());
+		for (size_t u = 0; u != n; ++u) {
+			for (auto k = g.offsets()[u]; k != g.offsets()[u + 1]; ++k) {
+				auto& x = d[u * n + static_cast<size_t>(g.targets()[k])];
+				x = std::min(x, g.weights()[k]);
+			}
+		}
+		return floyd_warshall(d, n, threads);
+	}
+	auto ret = std::vector<int>(n * n);
+	auto sources = std::vector<size_t>(n);
+	for (size_t i = 0; i != n; ++i) {
+		sources[i] = i;
+	}
+	dijkstra_batch(g, sources, [&ret, n](size_t i, dijkstra_workspace const& ws) {
+		for (size_t v = 0; v != n; ++v) {
+			ret[i * n + v] = ws.distance(v);
+		}
+	}, threads);
+	return ret;
+}
+
+#ifdef sparse_matrix_defined
+/// @brief 邻接矩阵的全源最短路
+/// @return N*N的行主序距离矩阵，不可达为int最大值
+/// @param m 邻接矩阵，存储的元素(i, j)即为边i->j
+/// @param method 算法
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam N 顶点数
+template <size_t N>
+std::vector<int> all_pairs(sparse_matrix2d<int, N, N> const& m, apsp_method method = apsp_method::Auto, size_t threads = 0)
+{
+	return all_pairs(csr_graph::from_matrix(m), method, threads);
+}
+#endif
+
+#define AllPairs_defined
+
+#endif
+
+#endif
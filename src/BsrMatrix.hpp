@@ -0,0 +1,376 @@
+#pragma once
+
+#ifndef BsrMatrix_disabled
+
+#ifndef BsrMatrix_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "SparseMatrix.hpp"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+/// @brief BSxBS稠密块的计算核
+/// @details
+/// 块以列主序存放，通用版本为标量循环
+/// @tparam T 矩阵元素类型
+/// @tparam BS 块大小
+template <typename T, size_t BS, typename = void>
+struct bsr_kernel
+{
+	/// @brief 块矩阵向量乘 acc += blk * x
+	/// @param blk 列主序块
+	/// @param x 长度为BS的输入向量
+	/// @param acc 长度为BS的累加向量
+	static void mv(T const* blk, T const* x, T* acc) noexcept
+	{
+		for (size_t c = 0; c != BS; ++c) {
+			auto xc = x[c];
+			for (size_t r = 0; r != BS; ++r) {
+				acc[r] += blk[c * BS + r] * xc;
+			}
+		}
+	}
+
+	/// @brief 块矩阵乘 c += a * b
+	/// @param a 列主序块
+	/// @param b 列主序块
+	/// @param c 列主序累加块
+	static void mm(T const* a, T const* b, T* c) noexcept
+	{
+		for (size_t j = 0; j != BS; ++j) {
+			for (size_t k = 0; k != BS; ++k) {
+				auto bkj = b[j * BS + k];
+				for (size_t r = 0; r != BS; ++r) {
+					c[j * BS + r] += a[k * BS + r] * bkj;
+				}
+			}
+		}
+	}
+};
+
+#ifdef __AVX2__
+/// @brief double类型块的AVX2计算核，要求BS为4的倍数
+/// @tparam BS 块大小
+template <size_t BS>
+struct bsr_kernel<double, BS, typename std::enable_if<BS % 4 == 0>::type>
+{
+	static __m256d madd(__m256d a, __m256d b, __m256d c) noexcept
+	{
+#ifdef __FMA__
+		return _mm256_fmadd_pd(a, b, c);
+#else
+		return _mm256_add_pd(_mm256_mul_pd(a, b), c);
+#endif
+	}
+
+	static void mv(double const* blk, double const* x, double* acc) noexcept
+	{
+		__m256d a[BS / 4];
+		for (size_t r = 0; r != BS / 4; ++r) {
+			a[r] = _mm256_loadu_pd(acc + 4 * r);
+		}
+		for (size_t c = 0; c != BS; ++c) {
+			auto xc = _mm256_broadcast_sd(x + c);
+			for (size_t r = 0; r != BS / 4; ++r) {
+				a[r] = madd(_mm256_loadu_pd(blk + c * BS + 4 * r), xc, a[r]);
+			}
+		}
+		for (size_t r = 0; r != BS / 4; ++r) {
+			_mm256_storeu_pd(acc + 4 * r, a[r]);
+		}
+	}
+
+	static void mm(double const* a, double const* b, double* c) noexcept
+	{
+		for (size_t j = 0; j != BS; ++j) {
+			__m256d s[BS / 4];
+			for (size_t r = 0; r != BS / 4; ++r) {
+				s[r] = _mm256_loadu_pd(c + j * BS + 4 * r);
+			}
+			for (size_t k = 0; k != BS; ++k) {
+				auto bkj = _mm256_broadcast_sd(b + j * BS + k);
+				for (size_t r = 0; r != BS / 4; ++r) {
+					s[r] = madd(_mm256_loadu_pd(a + k * BS + 4 * r), bkj, s[r]);
+				}
+			}
+			for (size_t r = 0; r != BS / 4; ++r) {
+				_mm256_storeu_pd(c + j * BS + 4 * r, s[r]);
+			}
+		}
+	}
+};
+
+/// @brief float类型块的AVX2计算核，要求BS为8的倍数
+/// @tparam BS 块大小
+template <size_t BS>
+struct bsr_kernel<float, BS, typename std::enable_if<BS % 8 == 0>::type>
+{
+	static __m256 madd(__m256 a, __m256 b, __m256 c) noexcept
+	{
+#ifdef __FMA__
+		return _mm256_fmadd_ps(a, b, c);
+#else
+		return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+	}
+
+	static void mv(float const* blk, float const* x, float* acc) noexcept
+	{
+		__m256 a[BS / 8];
+		for (size_t r = 0; r != BS / 8; ++r) {
+			a[r] = _mm256_loadu_ps(acc + 8 * r);
+		}
+		for (size_t c = 0; c != BS; ++c) {
+			auto xc = _mm256_broadcast_ss(x + c);
+			for (size_t r = 0; r != BS / 8; ++r) {
+				a[r] = madd(_mm256_loadu_ps(blk + c * BS + 8 * r), xc, a[r]);
+			}
+		}
+		for (size_t r = 0; r != BS / 8; ++r) {
+			_mm256_storeu_ps(acc + 8 * r, a[r]);
+		}
+	}
+
+	static void mm(float const* a, float const* b, float* c) noexcept
+	{
+		for (size_t j = 0; j != BS; ++j) {
+			__m256 s[BS / 8];
+			for (size_t r = 0; r != BS / 8; ++r) {
+				s[r] = _mm256_loadu_ps(c + j * BS + 8 * r);
+			}
+			for (size_t k = 0; k != BS; ++k) {
+				auto bkj = _mm256_broadcast_ss(b + j * BS + k);
+				for (size_t r = 0; r != BS / 8; ++r) {
+					s[r] = madd(_mm256_loadu_ps(a + k * BS + 8 * r), bkj, s[r]);
+				}
+			}
+			for (size_t r = 0; r != BS / 8; ++r) {
+				_mm256_storeu_ps(c + j * BS + 8 * r, s[r]);
+			}
+		}
+	}
+};
+#endif
+
+/// @brief 块压缩行存储(BSR)的二维稀疏矩阵
+/// @details
+/// 以BSxBS稠密块为单位压缩存储，适合有限元等块结构矩阵，块内运算由bsr_kernel完成
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+/// @tparam BS 块大小
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+class bsr_matrix
+{
+	static_assert(BS != 0, "Block size must be positive");
+	static_assert(DimA % BS == 0, "Row size must be a multiple of block size");
+	static_assert(DimB % BS == 0, "Col size must be a multiple of block size");
+
+public:
+	//声明所有模版特化为友元类
+	template<typename, size_t, size_t, size_t> friend class bsr_matrix;
+
+	/// 块行数
+	static constexpr size_t block_rows = DimA / BS;
+
+	/// 块列数
+	static constexpr size_t block_cols = DimB / BS;
+
+	/// 单个块的元素个数
+	static constexpr size_t block_size = BS * BS;
+
+	/// 默认构造函数，构造空矩阵
+	bsr_matrix();
+
+	/// @brief 由二维稀疏矩阵构造
+	/// @param m 源矩阵
+	explicit bsr_matrix(sparse_matrix2d<T, DimA, DimB> const& m);
+
+private:
+
+	/// 块行偏移，长度为block_rows + 1
+	std::vector<size_t> ptr;
+
+	/// 块列下标
+	std::vector<size_t> col;
+
+	/// 块内元素，每块block_size个，列主序
+	std::vector<T> val;
+
+public:
+
+	/// @brief 非零块个数
+	/// @return 存储的块个数
+	size_t blocks() const noexcept;
+
+	/// @brief 动态边界检查的获取
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 不带边界检查的矩阵向量乘 y = Ax
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量
+	void spmv(T const* x, T* y) const noexcept;
+
+	/// @brief 矩阵向量乘
+	/// @return Ax
+	/// @param x 长度为DimB的输入向量
+	std::vector<T> spmv(std::vector<T> const& x) const;
+
+	/// @brief AxB与BxC的分块矩阵乘积
+	/// @return 乘积
+	/// @param m2 目标矩阵
+	/// @tparam DimC 矩阵2的列数
+	template <size_t DimC>
+	bsr_matrix<T, DimA, DimC, BS> Mul(bsr_matrix<T, DimB, DimC, BS> const& m2) const;
+
+	/// @brief 转换为二维稀疏矩阵，块内的0不会被存储
+	/// @return 二维稀疏矩阵
+	sparse_matrix2d<T, DimA, DimB> to_sparse() const;
+};
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+bsr_matrix<T, DimA, DimB, BS>::bsr_matrix() : ptr(block_rows + 1)
+{ }
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+bsr_matrix<T, DimA, DimB, BS>::bsr_matrix(sparse_matrix2d<T, DimA, DimB> const& m) : ptr(block_rows + 1)
+{
+	auto mark = std::vector<size_t>(block_cols, block_rows);
+	auto slot = std::vector<size_t>(block_cols);
+	auto it = m.begin();
+	for (size_t bi = 0; bi != block_rows; ++bi) {
+		auto first = it;
+		auto base = col.size();
+		for (; it != m.end() && std::get<0>(it->first) / BS == bi; ++it) {
+			auto bj = std::get<1>(it->first) / BS;
+			if (mark[bj] != bi) {
+				mark[bj] = bi;
+				col.push_back(bj);
+			}
+		}
+		std::sort(col.begin() + base, col.end());
+		for (auto k = base; k != col.size(); ++k) {
+			slot[col[k]] = k;
+		}
+		val.resize(col.size() * block_size);
+		for (; first != it; ++first) {
+			auto r = std::get<0>(first->first);
+			auto c = std::get<1>(first->first);
+			val[slot[c / BS] * block_size + c % BS * BS + r % BS] = first->second;
+		}
+		ptr[bi + 1] = col.size();
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+size_t bsr_matrix<T, DimA, DimB, BS>::blocks() const noexcept
+{
+	return col.size();
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+T bsr_matrix<T, DimA, DimB, BS>::get(size_t DimAg, size_t DimBg) const
+{
+	if (DimA <= DimAg || DimB <= DimBg) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	auto b = col.begin() + ptr[DimAg / BS];
+	auto e = col.begin() + ptr[DimAg / BS + 1];
+	auto it = std::lower_bound(b, e, DimBg / BS);
+	if (it != e && *it == DimBg / BS) {
+		return val[(it - col.begin()) * block_size + DimBg % BS * BS + DimAg % BS];
+	}
+	return T();
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+void bsr_matrix<T, DimA, DimB, BS>::spmv(T const* x, T* y) const noexcept
+{
+	for (size_t bi = 0; bi != block_rows; ++bi) {
+		T acc[BS] = {};
+		for (auto k = ptr[bi]; k != ptr[bi + 1]; ++k) {
+			bsr_kernel<T, BS>::mv(val.data() + k * block_size, x + col[k] * BS, acc);
+		}
+		std::copy(acc, acc + BS, y + bi * BS);
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+std::vector<T> bsr_matrix<T, DimA, DimB, BS>::spmv(std::vector<T> const& x) const
+{
+	if (x.size() != DimB) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto y = std::vector<T>(DimA);
+	spmv(x.data(), y.data());
+	return y;
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+template <size_t DimC>
+bsr_matrix<T, DimA, DimC, BS> bsr_matrix<T, DimA, DimB, BS>::Mul(bsr_matrix<T, DimB, DimC, BS> const& m2) const
+{
+	using res_t = bsr_matrix<T, DimA, DimC, BS>;
+	res_t res;
+	auto acc = std::vector<T>(res_t::block_cols * block_size);
+	auto mark = std::vector<size_t>(res_t::block_cols, block_rows);
+	auto cols = std::vector<size_t>();
+	for (size_t bi = 0; bi != block_rows; ++bi) {
+		cols.clear();
+		for (auto k = ptr[bi]; k != ptr[bi + 1]; ++k) {
+			auto bk = col[k];
+			for (auto l = m2.ptr[bk]; l != m2.ptr[bk + 1]; ++l) {
+				auto bj = m2.col[l];
+				auto blk = acc.data() + bj * block_size;
+				if (mark[bj] != bi) {
+					mark[bj] = bi;
+					std::fill(blk, blk + block_size, T());
+					cols.push_back(bj);
+				}
+				bsr_kernel<T, BS>::mm(val.data() + k * block_size, m2.val.data() + l * block_size, blk);
+			}
+		}
+		std::sort(cols.begin(), cols.end());
+		for (auto bj : cols) {
+			auto blk = acc.data() + bj * block_size;
+			res.col.push_back(bj);
+			res.val.insert(res.val.end(), blk, blk + block_size);
+		}
+		res.ptr[bi + 1] = res.col.size();
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+sparse_matrix2d<T, DimA, DimB> bsr_matrix<T, DimA, DimB, BS>::to_sparse() const
+{
+	sparse_matrix2d<T, DimA, DimB> res;
+	for (size_t bi = 0; bi != block_rows; ++bi) {
+		for (size_t r = 0; r != BS; ++r) {
+			for (auto k = ptr[bi]; k != ptr[bi + 1]; ++k) {
+				for (size_t c = 0; c != BS; ++c) {
+					auto v = val[k * block_size + c * BS + r];
+					if (v != T()) {
+						res.push_back_unchecked(v, bi * BS + r, col[k] * BS + c);
+					}
+				}
+			}
+		}
+	}
+	return res;
+}
+
+#define BsrMatrix_defined
+
+#endif
+
+#endif
@@ -0,0 +1,325 @@
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <tuple>
+#include "ContractionHierarchy.h"
+
+#ifdef ContractionHierarchy_defined
+
+/**
+ * \brief 预处理期间剩余图中的边
+ */
+struct ch_arc
+{
+	/// 另一端点
+	size_t to;
+
+	/// 边权
+	int w;
+
+	/// 捷径的中间点
+	size_t via;
+};
+
+/**
+ * \brief 插入或缩短边，已有不更长的边时不做任何事
+ * \param arcs 边表
+ * \param to 另一端点
+ * \param w 边权
+ * \param via 捷径的中间点
+ * \return 插入或缩短时返回真
+ */
+static bool ch_insert(std::vector<ch_arc>& arcs, size_t to, int w, size_t via)
+{
+	for (auto& a : arcs) {
+		if (a.to == to) {
+			if (a.w <= w) {
+				return false;
+			}
+			a.w = w;
+			a.via = via;
+			return true;
+		}
+	}
+	arcs.push_back(ch_arc{ to, w, via });
+	return true;
+}
+
+/**
+ * \brief 删除到某顶点的边
+ * \param arcs 边表
+ * \param to 另一端点
+ */
+static void ch_erase(std::vector<ch_arc>& arcs, size_t to)
+{
+	arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [to](ch_arc const& a) { return a.to == to; }), arcs.end());
+}
+
+contraction_hierarchy::contraction_hierarchy(std::vector<std::vector<std::pair<size_t, int>>> const& m)
+{
+	build(m);
+}
+
+contraction_hierarchy::contraction_hierarchy(csr_graph const& g)
+{
+	auto m = std::vector<std::vector<std::pair<size_t, int>>>(g.vertices());
+	for (size_t u = 0; u != g.vertices(); ++u) {
+		for (auto k = g.offsets()[u]; k != g.offsets()[u + 1]; ++k) {
+			m[u].emplace_back(g.targets()[k], g.weights()[k]);
+		}
+	}
+	build(m);
+}
+
+void contraction_hierarchy::build(std::vector<std::vector<std::pair<size_t, int>>> const& out)
+{
+	const size_t settle_limit = 128;
+	auto n = out.size();
+	auto fwd = std::vector<std::vector<ch_arc>>(n);
+	auto bwd = std::vector<std::vector<ch_arc>>(n);
+	for (size_t u = 0; u != n; ++u) {
+		for (auto const& e : out[u]) {
+			if (e.first >= n) {
+				throw std::out_of_range("Graph bound check failed");
+			}
+			if (e.first != u && ch_insert(fwd[u], e.first, e.second, no_via)) {
+				ch_insert(bwd[e.first], u, e.second, no_via);
+			}
+		}
+	}
+
+	auto ws = dijkstra_workspace(n);
+	auto target = std::vector<size_t>(n, 0);
+	size_t round = 0;
+	auto adds = std::vector<std::tuple<size_t, size_t, int>>();
+	auto simulate = [&](size_t v) {
+		adds.clear();
+		auto max_out = 0;
+		++round;
+		for (auto const& a : fwd[v]) {
+			max_out = std::max(max_out, a.w);
+			target[a.to] = round;
+		}
+		for (auto const& in : bwd[v]) {
+			if (fwd[v].empty()) {
+				break;
+			}
+			auto u = in.to;
+			auto limit = path_weight<int>::add(in.w, max_out);
+			auto remaining = fwd[v].size() - (target[u] == round ? 1 : 0);
+			size_t settled = 0;
+			ws.reset(n);
+			ws.set(u, 0, u);
+			ws.push(u, 0);
+			while (!ws.empty() && remaining != 0) {
+				auto c = ws.pop();
+				if (c.first != ws.distance(c.second)) { continue; }
+				if (c.first > limit || ++settled > settle_limit) {
+					break;
+				}
+				if (target[c.second] == round && c.second != u) {
+					--remaining;
+				}
+				for (auto const& a : fwd[c.second]) {
+					auto nd = path_weight<int>::add(c.first, a.w);
+					if (a.to != v && nd < ws.distance(a.to)) {
+						ws.set(a.to, nd, c.second);
+						ws.push(a.to, nd);
+					}
+				}
+			}
+			for (auto const& o : fwd[v]) {
+				auto d = path_weight<int>::add(in.w, o.w);
+				if (o.to != u && d < ws.distance(o.to)) {
+					adds.emplace_back(u, o.to, d);
+				}
+			}
+		}
+	};
+	auto deleted = std::vector<size_t>(n, 0);
+	auto depth = std::vector<size_t>(n, 0);
+	auto priority = [&](size_t v) {
+		simulate(v);
+		return 2 * static_cast<long long>(adds.size()) - 2 * static_cast<long long>(fwd[v].size() + bwd[v].size()) +
+			static_cast<long long>(deleted[v] + depth[v]);
+	};
+
+	auto q = std::priority_queue<std::pair<long long, size_t>, std::vector<std::pair<long long, size_t>>, std::greater<>>();
+	for (size_t v = 0; v != n; ++v) {
+		q.emplace(priority(v), v);
+	}
+	auto upf = std::vector<std::vector<ch_arc>>(n);
+	auto upb = std::vector<std::vector<ch_arc>>(n);
+	level.assign(n, 0);
+	shortcut_count = 0;
+	size_t next = 0;
+	while (!q.empty()) {
+		auto v = q.top().second;
+		q.pop();
+		auto p = priority(v);
+		if (!q.empty() && p > q.top().first) {
+			q.emplace(p, v);
+			continue;
+		}
+		level[v] = next++;
+		for (auto const& a : fwd[v]) {
+			ch_erase(bwd[a.to], v);
+			++deleted[a.to];
+			depth[a.to] = std::max(depth[a.to], depth[v] + 1);
+		}
+		for (auto const& a : bwd[v]) {
+			ch_erase(fwd[a.to], v);
+			++deleted[a.to];
+			depth[a.to] = std::max(depth[a.to], depth[v] + 1);
+		}
+		for (auto const& s : adds) {
+			if (ch_insert(fwd[std::get<0>(s)], std::get<1>(s), std::get<2>(s), v)) {
+				ch_insert(bwd[std::get<1>(s)], std::get<0>(s), std::get<2>(s), v);
+				++shortcut_count;
+			}
+		}
+		upf[v].swap(fwd[v]);
+		upb[v].swap(bwd[v]);
+	}
+
+	auto flatten = [n](std::vector<std::vector<ch_arc>> const& arcs, csr_graph& g, std::vector<size_t>& vias) {
+		auto offsets = std::vector<size_t>(n + 1, 0);
+		auto targets = std::vector<size_t>();
+		auto weights = std::vector<int>();
+		vias.clear();
+		for (size_t u = 0; u != n; ++u) {
+			for (auto const& a : arcs[u]) {
+				targets.push_back(a.to);
+				weights.push_back(a.w);
+				vias.push_back(a.via);
+			}
+			offsets[u + 1] = targets.size();
+		}
+		g = csr_graph(std::move(offsets), std::move(targets), std::move(weights));
+	};
+	flatten(upf, up[0], via[0]);
+	flatten(upb, up[1], via[1]);
+}
+
+std::pair<int, size_t> contraction_hierarchy::search(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const
+{
+	auto n = vertices();
+	if (s >= n || t >= n) {
+		throw std::out_of_range("Graph bound check failed");
+	}
+	dijkstra_workspace* ws[2] = { &fw, &bw };
+	auto best = std::numeric_limits<int>::max();
+	auto meet = n;
+	fw.reset(n);
+	bw.reset(n);
+	fw.set(s, 0, s);
+	bw.set(t, 0, t);
+	fw.push(s, 0);
+	bw.push(t, 0);
+	for (;;) {
+		for (auto w : ws) {
+			while (!w->empty() && w->top().first != w->distance(w->top().second)) {
+				w->pop();
+			}
+		}
+		auto f = !fw.empty() && fw.top().first < best;
+		auto b = !bw.empty() && bw.top().first < best;
+		if (!f && !b) {
+			break;
+		}
+		auto x = f && (!b || fw.top().first <= bw.top().first) ? 0 : 1;
+		auto& a = *ws[x];
+		auto& o = *ws[1 - x];
+		auto c = a.pop();
+		auto u = c.second;
+		if (o.reached(u) && c.first < best - o.distance(u)) {
+			best = c.first + o.distance(u);
+			meet = u;
+		}
+		auto const& offsets = up[x].offsets();
+		auto const& targets = up[x].targets();
+		auto const& weights = up[x].weights();
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = targets[k];
+			auto nd = path_weight<int>::add(c.first, weights[k]);
+			if (nd < a.distance(v)) {
+				a.set(v, nd, u);
+				a.push(v, nd);
+			}
+		}
+	}
+	return std::make_pair(best, meet);
+}
+
+void contraction_hierarchy::unpack(size_t u, size_t w, std::vector<size_t>& path) const
+{
+	auto x = level[u] < level[w] ? 0 : 1;
+	auto from = x == 0 ? u : w;
+	auto to = x == 0 ? w : u;
+	auto const& offsets = up[x].offsets();
+	auto const& targets = up[x].targets();
+	auto k = offsets[from];
+	while (targets[k] != to) {
+		++k;
+	}
+	if (via[x][k] == no_via) {
+		path.push_back(w);
+	} else {
+		unpack(u, via[x][k], path);
+		unpack(via[x][k], w, path);
+	}
+}
+
+int contraction_hierarchy::distance(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const
+{
+	return search(s, t, fw, bw).first;
+}
+
+shortest_path_result contraction_hierarchy::query(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const
+{
+	auto r = search(s, t, fw, bw);
+	if (r.second == vertices()) {
+		return shortest_path_result{ r.first, {} };
+	}
+	auto upward = fw.path(r.second);
+	auto path = std::vector<size_t>{ s };
+	for (size_t i = 1; i < upward.size(); ++i) {
+		unpack(upward[i - 1], upward[i], path);
+	}
+	for (auto v = r.second; v != t;) {
+		auto next = bw.predecessor(v);
+		unpack(v, next, path);
+		v = next;
+	}
+	return shortest_path_result{ r.first, std::move(path) };
+}
+
+shortest_path_result contraction_hierarchy::query(size_t s, size_t t) const
+{
+	auto fw = dijkstra_workspace(vertices());
+	auto bw = dijkstra_workspace(vertices());
+	return query(s, t, fw, bw);
+}
+
+size_t contraction_hierarchy::vertices() const noexcept
+{
+	return level.size();
+}
+
+size_t contraction_hierarchy::shortcuts() const noexcept
+{
+	return shortcut_count;
+}
+
+size_t contraction_hierarchy::bytes() const noexcept
+{
+	return level.size() * sizeof(size_t) + up[0].bytes() + up[1].bytes() + (via[0].size() + via[1].size()) * sizeof(size_t);
+}
+
+size_t contraction_hierarchy::rank(size_t v) const noexcept
+{
+	return level[v];
+}
+
+#endif
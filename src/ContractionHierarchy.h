@@ -0,0 +1,133 @@
+#pragma once
+
+#ifndef ContractionHierarchy_disabled
+
+#ifndef ContractionHierarchy_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <array>
+#include <utility>
+#include <vector>
+#include "CsrGraph.hpp"
+#include "Dijkstra.h"
+
+/**
+ * \brief 收缩层次(Contraction Hierarchies)，用于静态图上大量的点对点最短路查询
+ * \details
+ * 预处理按边差(新增捷径数 - 删除的边数 + 已收缩的邻居数)的顺序逐个收缩顶点，
+ * 收缩v时对每对入邻居u与出邻居w做有界的见证搜索，找不到不经过v且不更长的路径时插入捷径u->w。
+ * 查询时从起点沿向上的边正向搜索、从终点沿向上的边反向搜索，两侧只访问层次更高的顶点，
+ * 捷径在还原路径时递归展开为原图的边
+ */
+class contraction_hierarchy
+{
+	/// 表示原图边(非捷径)的中间点
+	static constexpr size_t no_via = static_cast<size_t>(-1);
+
+	/// 顶点的层次，越晚收缩越高
+	std::vector<size_t> level;
+
+	/// 向上的边，up[0]为u->w(level[u] < level[w])，up[1]为反向存储的u->w(level[u] > level[w])，即w处存u
+	std::array<csr_graph, 2> up;
+
+	/// 与up中每条边对应的捷径中间点，原图的边为no_via
+	std::array<std::vector<size_t>, 2> via;
+
+	/// 捷径数
+	size_t shortcut_count = 0;
+
+	/**
+	 * \brief 由去重后的出边表预处理
+	 * \param out 每个顶点的出边(终点, 边权)
+	 */
+	void build(std::vector<std::vector<std::pair<size_t, int>>> const& out);
+
+	/**
+	 * \brief 双向向上搜索
+	 * \param s 起点
+	 * \param t 终点
+	 * \param fw 正向工作区
+	 * \param bw 反向工作区
+	 * \return (最短距离, 相遇点)，不可达时相遇点为顶点数
+	 */
+	std::pair<int, size_t> search(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const;
+
+	/**
+	 * \brief 将边u->w展开为原图的边，依次追加除u外的顶点
+	 * \param u 起点
+	 * \param w 终点
+	 * \param path 路径
+	 */
+	void unpack(size_t u, size_t w, std::vector<size_t>& path) const;
+
+public:
+	/**
+	 * \brief 由dijkstra使用的邻接表预处理
+	 * \param m 邻接表，边权需非负
+	 */
+	explicit contraction_hierarchy(std::vector<std::vector<std::pair<size_t, int>>> const& m);
+
+	/**
+	 * \brief 由CSR图预处理
+	 * \param g 图，边权需非负
+	 */
+	explicit contraction_hierarchy(csr_graph const& g);
+
+	/**
+	 * \brief 点对点最短距离，不还原路径
+	 * \param s 起点
+	 * \param t 终点
+	 * \param fw 正向工作区
+	 * \param bw 反向工作区
+	 * \return 最短距离，不可达为int最大值
+	 */
+	int distance(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const;
+
+	/**
+	 * \brief 点对点最短路
+	 * \param s 起点
+	 * \param t 终点
+	 * \param fw 正向工作区
+	 * \param bw 反向工作区
+	 * \return 最短距离与原图上的路径
+	 */
+	shortest_path_result query(size_t s, size_t t, dijkstra_workspace& fw, dijkstra_workspace& bw) const;
+
+	/**
+	 * \brief 点对点最短路，每次调用分配新的工作区
+	 * \param s 起点
+	 * \param t 终点
+	 * \return 最短距离与原图上的路径
+	 */
+	shortest_path_result query(size_t s, size_t t) const;
+
+	/**
+	 * \brief 顶点数
+	 * \return 顶点数
+	 */
+	size_t vertices() const noexcept;
+
+	/**
+	 * \brief 插入的捷径数
+	 * \return 捷径数
+	 */
+	size_t shortcuts() const noexcept;
+
+	/**
+	 * \brief 索引占用的字节数
+	 * \return 层次、向上的边与捷径中间点的总字节数
+	 */
+	size_t bytes() const noexcept;
+
+	/**
+	 * \brief 顶点的层次
+	 * \param v 顶点
+	 * \return 收缩顺序，越大越晚收缩
+	 */
+	size_t rank(size_t v) const noexcept;
+};
+
+#define ContractionHierarchy_defined
+
+#endif
+
+#endif
@@ -0,0 +1,695 @@
+#pragma once
+
+#ifndef CsrFile_disabled
+
+#ifndef CsrFile_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Semiring.hpp"
+#include "SparseMatrix.hpp"
+#include "CsrMatrix.hpp"
+#include "StrException.h"
+
+/// @brief 二进制CSR文件头
+/// @details
+/// 文件依次为文件头、行偏移(DimA + 1个uint64)、列下标(nnz个uint64)与元素值(nnz个T)，
+/// 各段起点由文件头给出并按64字节对齐，以便直接mmap后按原生类型访问
+struct csr_file_header
+{
+	/// 魔数"DSXCSR1"
+	char magic[8];
+
+	/// 元素类型大小
+	uint64_t elem_size;
+
+	/// 行数
+	uint64_t dim_a;
+
+	/// 列数
+	uint64_t dim_b;
+
+	/// 非零元素个数
+	uint64_t nnz;
+
+	/// 行偏移段起点
+	uint64_t ptr_off;
+
+	/// 列下标段起点
+	uint64_t col_off;
+
+	/// 元素值段起点
+	uint64_t val_off;
+};
+
+/// @brief 按行顺序流式写出二进制CSR文件
+/// @details
+/// 行偏移与列下标按块写入目标文件，元素值先写入临时文件，关闭时拼接到末尾，
+/// 内存占用与矩阵大小无关
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+class csr_file_writer
+{
+public:
+	/// @brief 创建文件并开始写入第0行
+	/// @param path 文件路径
+	/// @param chunk 缓冲的元素个数
+	explicit csr_file_writer(std::string const& path, size_t chunk = 1 << 16);
+
+	csr_file_writer(csr_file_writer const&) = delete;
+
+	csr_file_writer& operator=(csr_file_writer const&) = delete;
+
+	/// 析构函数，未关闭时丢弃写入的内容
+	~csr_file_writer();
+
+	/// @brief 在当前行末尾追加元素
+	/// @param DimBs 列坐标，需大于当前行已追加的列坐标
+	/// @param ele 值
+	void append(size_t DimBs, T ele);
+
+	/// 结束当前行
+	void end_row();
+
+	/// @brief 结束剩余的行并写入文件头
+	void close();
+
+private:
+
+	/// 目标文件路径
+	std::string path;
+
+	/// 目标文件
+	int fd;
+
+	/// 元素值临时文件
+	std::FILE* tmp;
+
+	/// 缓冲大小
+	size_t chunk;
+
+	/// 已结束的行数
+	size_t rows = 0;
+
+	/// 已追加的元素个数
+	uint64_t nnz = 0;
+
+	/// 当前行最后的列坐标
+	size_t last = 0;
+
+	/// 当前行是否为空
+	bool empty = true;
+
+	/// 已写出的行偏移个数
+	uint64_t ptr_flushed = 0;
+
+	/// 已写出的列下标个数
+	uint64_t col_flushed = 0;
+
+	/// 待写出的行偏移
+	std::vector<uint64_t> ptr_buf;
+
+	/// 待写出的列下标
+	std::vector<uint64_t> col_buf;
+
+	/// 待写出的元素值
+	std::vector<T> val_buf;
+
+	/// 行偏移段起点
+	static constexpr uint64_t ptr_off = 64;
+
+	/// 列下标段起点
+	static constexpr uint64_t col_off = (ptr_off + (DimA + 1) * sizeof(uint64_t) + 63) / 64 * 64;
+
+	/// @brief 在指定位置写出全部数据
+	void put(void const* data, size_t n, uint64_t off);
+
+	/// 写出缓冲
+	void flush();
+};
+
+/// @brief 只读映射到内存的二进制CSR文件
+/// @details
+/// 通过mmap访问磁盘上的矩阵，运算时按行块(panel)顺序扫描，
+/// 扫描前对行块给出顺序读取的建议，扫描完的行块会通知内核释放，常驻内存与行块大小而非矩阵大小相关；
+/// 映射时校验各段长度、行偏移与列下标，损坏的文件不会导致越界访问
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+class mapped_csr_matrix
+{
+public:
+	//声明所有模版特化为友元类
+	template<typename, size_t, size_t> friend class mapped_csr_matrix;
+
+	/// @brief 映射文件
+	/// @details 文件头、各段长度、行偏移或列下标不正确时抛出str_exception
+	/// @param path 文件路径
+	explicit mapped_csr_matrix(std::string const& path);
+
+	mapped_csr_matrix(mapped_csr_matrix const&) = delete;
+
+	mapped_csr_matrix& operator=(mapped_csr_matrix const&) = delete;
+
+	/// 移动构造函数
+	mapped_csr_matrix(mapped_csr_matrix&& m) noexcept;
+
+	/// 析构函数，解除映射
+	~mapped_csr_matrix();
+
+private:
+
+	/// 映射起点
+	char* base = nullptr;
+
+	/// 映射长度
+	size_t length = 0;
+
+	/// 非零元素个数
+	size_t nnz = 0;
+
+	/// 行偏移
+	uint64_t const* ptr = nullptr;
+
+	/// 列下标
+	uint64_t const* col = nullptr;
+
+	/// 元素值
+	T const* val = nullptr;
+
+	/// @brief 对地址范围内的页给出madvise建议
+	/// @param lo 起点
+	/// @param hi 终点
+	/// @param advice 建议
+	/// @param whole 为真时向外扩展到整页，否则只取完全位于范围内的页
+	static void advise(void const* lo, void const* hi, int advice, bool whole) noexcept;
+
+	/// @brief 通知内核将顺序读取行[b, e)所占的页
+	void stream(size_t b, size_t e) const noexcept;
+
+	/// @brief 通知内核列下标与元素值将被随机读取
+	void scatter() const noexcept;
+
+	/// @brief 通知内核释放行[b, e)所占的页
+	void release(size_t b, size_t e) const noexcept;
+
+public:
+
+	/// @brief 非零元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept;
+
+	/// @brief 行偏移数组
+	/// @return 长度为DimA + 1的行偏移
+	uint64_t const* row_ptr() const noexcept;
+
+	/// @brief 列下标数组
+	/// @return 列下标
+	uint64_t const* col_idx() const noexcept;
+
+	/// @brief 元素值数组
+	/// @return 元素值
+	T const* values() const noexcept;
+
+	/// @brief 动态边界检查的获取
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 按半环解释未存储元素的动态边界检查的获取
+	/// @details 半环乘积不存储等于zero的元素，读取Mul<S>的结果时应使用此重载，如min_plus下不可达为无穷大而非0
+	/// @return 值，未存储时为S::zero()
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	/// @tparam S 半环
+	template <typename S>
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 按行块扫描的矩阵向量乘 y = Ax，不带边界检查
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量
+	/// @param panel 行块的行数
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	void spmv(T const* x, T* y, size_t panel = 1 << 16) const noexcept;
+
+	/// @brief 矩阵向量乘
+	/// @return Ax
+	/// @param x 长度为DimB的输入向量
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	std::vector<T> spmv(std::vector<T> const& x) const;
+
+	/// @brief AxB与BxC的矩阵乘积，结果按行流式写入文件
+	/// @details 本矩阵按行块扫描，m2随机访问，结果为半环zero的元素不会被存储
+	/// @param m2 目标矩阵
+	/// @param path 结果文件路径
+	/// @param panel 行块的行数
+	/// @tparam S 半环，默认为普通加乘
+	/// @tparam DimC 矩阵2的列数
+	template <typename S = plus_times<T>, size_t DimC>
+	void Mul(mapped_csr_matrix<T, DimB, DimC> const& m2, std::string const& path, size_t panel = 1 << 16) const;
+
+	/// @brief 读入内存
+	/// @return CSR矩阵
+	csr_matrix<T, DimA, DimB> load() const;
+};
+
+/// @brief 二进制CSR文件的读写
+struct csr_file
+{
+	/// @brief 将CSR矩阵写入文件
+	/// @param path 文件路径
+	/// @param m 矩阵
+	template <typename T, size_t DimA, size_t DimB>
+	static void write(std::string const& path, csr_matrix<T, DimA, DimB> const& m);
+
+	/// @brief 将二维稀疏矩阵写入文件
+	/// @param path 文件路径
+	/// @param m 矩阵
+	template <typename T, size_t DimA, size_t DimB>
+	static void write(std::string const& path, sparse_matrix2d<T, DimA, DimB> const& m);
+
+	/// @brief 映射文件
+	/// @return 映射的矩阵
+	/// @param path 文件路径
+	template <typename T, size_t DimA, size_t DimB>
+	static mapped_csr_matrix<T, DimA, DimB> map(std::string const& path);
+};
+
+template <typename T, size_t DimA, size_t DimB>
+csr_file_writer<T, DimA, DimB>::csr_file_writer(std::string const& path, size_t chunk) : path(path), chunk(std::max<size_t>(chunk, 1))
+{
+	fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0) {
+		throw str_exception(path, L"无法打开文件");
+	}
+	tmp = std::tmpfile();
+	if (tmp == nullptr) {
+		::close(fd);
+		throw str_exception(path, L"无法创建临时文件");
+	}
+	ptr_buf.push_back(0);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+csr_file_writer<T, DimA, DimB>::~csr_file_writer()
+{
+	if (fd >= 0) {
+		::close(fd);
+		std::fclose(tmp);
+		std::remove(path.c_str());
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file_writer<T, DimA, DimB>::put(void const* data, size_t n, uint64_t off)
+{
+	auto p = static_cast<char const*>(data);
+	while (n != 0) {
+		auto w = ::pwrite(fd, p, n, static_cast<off_t>(off));
+		if (w <= 0) {
+			throw str_exception(path, L"写入文件失败");
+		}
+		p += w;
+		n -= static_cast<size_t>(w);
+		off += static_cast<uint64_t>(w);
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file_writer<T, DimA, DimB>::flush()
+{
+	put(ptr_buf.data(), ptr_buf.size() * sizeof(uint64_t), ptr_off + ptr_flushed * sizeof(uint64_t));
+	ptr_flushed += ptr_buf.size();
+	ptr_buf.clear();
+	put(col_buf.data(), col_buf.size() * sizeof(uint64_t), col_off + col_flushed * sizeof(uint64_t));
+	col_flushed += col_buf.size();
+	col_buf.clear();
+	if (std::fwrite(val_buf.data(), sizeof(T), val_buf.size(), tmp) != val_buf.size()) {
+		throw str_exception(path, L"写入文件失败");
+	}
+	val_buf.clear();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file_writer<T, DimA, DimB>::append(size_t DimBs, T ele)
+{
+	if (DimA <= rows || DimB <= DimBs || (!empty && DimBs <= last)) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	col_buf.push_back(DimBs);
+	val_buf.push_back(ele);
+	++nnz;
+	last = DimBs;
+	empty = false;
+	if (col_buf.size() >= chunk) {
+		flush();
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file_writer<T, DimA, DimB>::end_row()
+{
+	if (DimA <= rows) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	++rows;
+	ptr_buf.push_back(nnz);
+	empty = true;
+	if (ptr_buf.size() >= chunk) {
+		flush();
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file_writer<T, DimA, DimB>::close()
+{
+	while (rows != DimA) {
+		end_row();
+	}
+	flush();
+
+	auto val_off = (col_off + nnz * sizeof(uint64_t) + 63) / 64 * 64;
+	std::rewind(tmp);
+	auto buf = std::vector<char>(1 << 20);
+	auto off = val_off;
+	size_t n;
+	while ((n = std::fread(buf.data(), 1, buf.size(), tmp)) != 0) {
+		put(buf.data(), n, off);
+		off += n;
+	}
+	if (off != val_off + nnz * sizeof(T) || ::ftruncate(fd, static_cast<off_t>(off)) != 0) {
+		throw str_exception(path, L"写入文件失败");
+	}
+
+	csr_file_header h;
+	std::memcpy(h.magic, "DSXCSR1", 8);
+	h.elem_size = sizeof(T);
+	h.dim_a = DimA;
+	h.dim_b = DimB;
+	h.nnz = nnz;
+	h.ptr_off = ptr_off;
+	h.col_off = col_off;
+	h.val_off = val_off;
+	put(&h, sizeof(h), 0);
+
+	::close(fd);
+	std::fclose(tmp);
+	fd = -1;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+mapped_csr_matrix<T, DimA, DimB>::mapped_csr_matrix(std::string const& path)
+{
+	auto fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		throw str_exception(path, L"无法打开文件");
+	}
+	struct stat st;
+	if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(csr_file_header)) {
+		::close(fd);
+		throw str_exception(path, L"错误的文件头");
+	}
+	length = static_cast<size_t>(st.st_size);
+	auto p = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (p == MAP_FAILED) {
+		throw str_exception(path, L"无法映射文件");
+	}
+	base = static_cast<char*>(p);
+
+	csr_file_header h;
+	std::memcpy(&h, base, sizeof(h));
+	auto fail = [this, &path](wchar_t const* error) {
+		::munmap(base, length);
+		base = nullptr;
+		throw str_exception(path, error);
+	};
+	if (std::memcmp(h.magic, "DSXCSR1", 8) != 0 || h.ptr_off % 8 != 0 || h.col_off % 8 != 0 || h.val_off % alignof(T) != 0) {
+		fail(L"错误的文件头");
+	}
+	if (h.elem_size != sizeof(T)) {
+		fail(L"元素类型不匹配");
+	}
+	if (h.dim_a != DimA || h.dim_b != DimB) {
+		fail(L"矩阵维度不匹配");
+	}
+	auto fits = [this](uint64_t off, uint64_t count, size_t elem) {
+		return off <= length && count <= (length - off) / elem;
+	};
+	if (!fits(h.ptr_off, uint64_t(DimA) + 1, sizeof(uint64_t)) || !fits(h.col_off, h.nnz, sizeof(uint64_t)) || !fits(h.val_off, h.nnz, sizeof(T))) {
+		fail(L"文件长度不足");
+	}
+	nnz = static_cast<size_t>(h.nnz);
+	ptr = reinterpret_cast<uint64_t const*>(base + h.ptr_off);
+	col = reinterpret_cast<uint64_t const*>(base + h.col_off);
+	val = reinterpret_cast<T const*>(base + h.val_off);
+	if (ptr[0] != 0 || ptr[DimA] != h.nnz) {
+		fail(L"错误的行偏移");
+	}
+	for (size_t i = 0; i != DimA; ++i) {
+		if (ptr[i + 1] < ptr[i]) {
+			fail(L"错误的行偏移");
+		}
+	}
+	for (size_t k = 0; k != nnz; ++k) {
+		if (DimB <= col[k]) {
+			fail(L"列下标越界");
+		}
+	}
+	release(0, DimA);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+mapped_csr_matrix<T, DimA, DimB>::mapped_csr_matrix(mapped_csr_matrix&& m) noexcept
+	: base(m.base), length(m.length), nnz(m.nnz), ptr(m.ptr), col(m.col), val(m.val)
+{
+	m.base = nullptr;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+mapped_csr_matrix<T, DimA, DimB>::~mapped_csr_matrix()
+{
+	if (base != nullptr) {
+		::munmap(base, length);
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void mapped_csr_matrix<T, DimA, DimB>::advise(void const* lo, void const* hi, int advice, bool whole) noexcept
+{
+	auto page = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE));
+	auto l = reinterpret_cast<uintptr_t>(lo);
+	auto h = reinterpret_cast<uintptr_t>(hi);
+	l = whole ? l / page * page : (l + page - 1) / page * page;
+	h = whole ? (h + page - 1) / page * page : h / page * page;
+	if (l < h) {
+		::madvise(reinterpret_cast<void*>(l), h - l, advice);
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void mapped_csr_matrix<T, DimA, DimB>::stream(size_t b, size_t e) const noexcept
+{
+	advise(col + ptr[b], col + ptr[e], MADV_SEQUENTIAL, true);
+	advise(val + ptr[b], val + ptr[e], MADV_SEQUENTIAL, true);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void mapped_csr_matrix<T, DimA, DimB>::scatter() const noexcept
+{
+	advise(col, col + nnz, MADV_RANDOM, true);
+	advise(val, val + nnz, MADV_RANDOM, true);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void mapped_csr_matrix<T, DimA, DimB>::release(size_t b, size_t e) const noexcept
+{
+	advise(col + ptr[b], col + ptr[e], MADV_DONTNEED, false);
+	advise(val + ptr[b], val + ptr[e], MADV_DONTNEED, false);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t mapped_csr_matrix<T, DimA, DimB>::size() const noexcept
+{
+	return nnz;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+uint64_t const* mapped_csr_matrix<T, DimA, DimB>::row_ptr() const noexcept
+{
+	return ptr;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+uint64_t const* mapped_csr_matrix<T, DimA, DimB>::col_idx() const noexcept
+{
+	return col;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+T const* mapped_csr_matrix<T, DimA, DimB>::values() const noexcept
+{
+	return val;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+T mapped_csr_matrix<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	return get<plus_times<T>>(DimAg, DimBg);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+T mapped_csr_matrix<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	if (DimA <= DimAg || DimB <= DimBg) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	auto b = col + ptr[DimAg];
+	auto e = col + ptr[DimAg + 1];
+	auto it = std::lower_bound(b, e, uint64_t(DimBg));
+	if (it != e && *it == DimBg) {
+		return val[it - col];
+	}
+	return S::zero();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+void mapped_csr_matrix<T, DimA, DimB>::spmv(T const* x, T* y, size_t panel) const noexcept
+{
+	panel = std::max<size_t>(panel, 1);
+	for (size_t b = 0; b < DimA; b += panel) {
+		auto e = std::min(DimA, b + panel);
+		stream(b, e);
+		for (auto i = b; i != e; ++i) {
+			T a = S::zero();
+			for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+				a = S::add(a, S::mul(val[k], x[col[k]]));
+			}
+			y[i] = a;
+		}
+		release(b, e);
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+std::vector<T> mapped_csr_matrix<T, DimA, DimB>::spmv(std::vector<T> const& x) const
+{
+	if (x.size() != DimB) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto y = std::vector<T>(DimA);
+	spmv<S>(x.data(), y.data());
+	return y;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S, size_t DimC>
+void mapped_csr_matrix<T, DimA, DimB>::Mul(mapped_csr_matrix<T, DimB, DimC> const& m2, std::string const& path, size_t panel) const
+{
+	auto out = csr_file_writer<T, DimA, DimC>(path);
+	auto acc = std::vector<T>(DimC);
+	auto mark = std::vector<size_t>(DimC, DimA);
+	auto cols = std::vector<size_t>();
+	panel = std::max<size_t>(panel, 1);
+	m2.scatter();
+	for (size_t b = 0; b < DimA; b += panel) {
+		auto e = std::min(DimA, b + panel);
+		stream(b, e);
+		for (auto i = b; i != e; ++i) {
+			cols.clear();
+			for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+				auto r = col[k];
+				for (auto l = m2.ptr[r]; l != m2.ptr[r + 1]; ++l) {
+					auto c = m2.col[l];
+					if (mark[c] != i) {
+						mark[c] = i;
+						acc[c] = S::mul(val[k], m2.val[l]);
+						cols.push_back(c);
+					} else {
+						acc[c] = S::add(acc[c], S::mul(val[k], m2.val[l]));
+					}
+				}
+			}
+			std::sort(cols.begin(), cols.end());
+			for (auto c : cols) {
+				if (acc[c] != S::zero()) {
+					out.append(c, acc[c]);
+				}
+			}
+			out.end_row();
+		}
+		release(b, e);
+	}
+	out.close();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+csr_matrix<T, DimA, DimB> mapped_csr_matrix<T, DimA, DimB>::load() const
+{
+	csr_matrix<T, DimA, DimB> res;
+	std::copy(ptr, ptr + DimA + 1, res.ptr.begin());
+	res.col.assign(col, col + nnz);
+	res.val.assign(val, val + nnz);
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file::write(std::string const& path, csr_matrix<T, DimA, DimB> const& m)
+{
+	auto out = csr_file_writer<T, DimA, DimB>(path);
+	auto& ptr = m.row_ptr();
+	auto& col = m.col_idx();
+	auto& val = m.values();
+	for (size_t i = 0; i != DimA; ++i) {
+		for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+			out.append(col[k], val[k]);
+		}
+		out.end_row();
+	}
+	out.close();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void csr_file::write(std::string const& path, sparse_matrix2d<T, DimA, DimB> const& m)
+{
+	auto out = csr_file_writer<T, DimA, DimB>(path);
+	size_t r = 0;
+	for (auto const& ele : m) {
+		for (; r != std::get<0>(ele.first); ++r) {
+			out.end_row();
+		}
+		out.append(std::get<1>(ele.first), ele.second);
+	}
+	out.close();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+mapped_csr_matrix<T, DimA, DimB> csr_file::map(std::string const& path)
+{
+	return mapped_csr_matrix<T, DimA, DimB>(path);
+}
+
+#define CsrFile_defined
+
+#endif
+
+#endif
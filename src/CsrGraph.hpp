@@ -0,0 +1,270 @@
+#pragma once
+
+#ifndef CsrGraph_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "SparseMatrix.hpp"
+
+/// @brief 压缩行存储(CSR)的带权有向图
+/// @details
+/// 顶点v的出边为下标[offsets()[v], offsets()[v + 1])内的targets()与weights()，
+/// 三个数组连续存放，避免邻接表每个顶点一次分配，供dijkstra、kruskal等图算法共用
+/// @tparam Id 顶点编号类型，可取32位以减小内存占用
+/// @tparam W 边权类型
+template <typename Id = size_t, typename W = int>
+class basic_csr_graph
+{
+public:
+	/// 顶点编号类型
+	using id_t = Id;
+
+	/// 边权类型
+	using weight_t = W;
+
+	/// 边类型(权, 起点, 终点)，与kruskal的结果相同
+	using edge_t = std::tuple<W, size_t, size_t>;
+
+	/// 默认构造函数，构造空图
+	basic_csr_graph();
+
+	/// @brief 由CSR数组直接构造
+	/// @param offsets 出边偏移，长度为顶点数 + 1
+	/// @param targets 终点
+	/// @param weights 边权
+	basic_csr_graph(std::vector<size_t> offsets, std::vector<Id> targets, std::vector<W> weights);
+
+private:
+
+	/// 出边偏移，长度为顶点数 + 1
+	std::vector<size_t> offset;
+
+	/// 终点
+	std::vector<Id> target;
+
+	/// 边权
+	std::vector<W> weight;
+
+	/// @brief 检查顶点数能否以Id表示
+	/// @param n 顶点数
+	static void id_check(size_t n);
+
+public:
+
+	/// @brief 由边列表构造
+	/// @details 计数排序，同一起点的边保持输入顺序
+	/// @return 图
+	/// @param n 顶点数
+	/// @param edges 边列表
+	/// @param undirected 为真时每条边同时加入反向边
+	static basic_csr_graph from_edges(size_t n, std::vector<edge_t> const& edges, bool undirected = false);
+
+#ifdef sparse_matrix_defined
+	/// @brief 由邻接矩阵构造，存储的元素(i, j)即为边i->j
+	/// @return 图
+	/// @param m 邻接矩阵
+	/// @tparam N 顶点数
+	template <size_t N>
+	static basic_csr_graph from_matrix(sparse_matrix2d<W, N, N> const& m);
+#endif
+
+	/// @brief 反向图，边u->v变为v->u
+	/// @details 计数排序，供需要入边的算法(如双向搜索)使用，无向图的反向图即为自身
+	/// @return 反向图
+	basic_csr_graph reverse() const;
+
+	/// @brief 顶点数
+	/// @return 顶点数
+	size_t vertices() const noexcept;
+
+	/// @brief 边数
+	/// @return 边数
+	size_t edges() const noexcept;
+
+	/// @brief 出度
+	/// @return 顶点v的出边数
+	/// @param v 顶点
+	size_t degree(size_t v) const noexcept;
+
+	/// @brief 占用的字节数
+	/// @return 三个数组的总字节数
+	size_t bytes() const noexcept;
+
+	/// @brief 出边偏移数组
+	/// @return 长度为顶点数 + 1的出边偏移
+	std::vector<size_t> const& offsets() const noexcept;
+
+	/// @brief 终点数组
+	/// @return 终点
+	std::vector<Id> const& targets() const noexcept;
+
+	/// @brief 边权数组
+	/// @return 边权
+	std::vector<W> const& weights() const noexcept;
+};
+
+/// 64位顶点编号的CSR图
+using csr_graph = basic_csr_graph<size_t, int>;
+
+/// 32位顶点编号的CSR图
+using csr_graph32 = basic_csr_graph<std::uint32_t, int>;
+
+template <typename Id, typename W>
+basic_csr_graph<Id, W>::basic_csr_graph() : offset(1)
+{ }
+
+template <typename Id, typename W>
+basic_csr_graph<Id, W>::basic_csr_graph(std::vector<size_t> offsets, std::vector<Id> targets, std::vector<W> weights) :
+	offset(std::move(offsets)), target(std::move(targets)), weight(std::move(weights))
+{
+	if (offset.empty() || offset.front() != 0 || offset.back() != target.size() || target.size() != weight.size() ||
+		!std::is_sorted(offset.begin(), offset.end())) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	id_check(offset.size() - 1);
+	for (auto t : target) {
+		if (static_cast<size_t>(t) >= offset.size() - 1) {
+			throw std::out_of_range("Graph bound check failed");
+		}
+	}
+}
+
+template <typename Id, typename W>
+void basic_csr_graph<Id, W>::id_check(size_t n)
+{
+	if (n > static_cast<size_t>(std::numeric_limits<Id>::max())) {
+		throw std::out_of_range("Graph bound check failed");
+	}
+}
+
+template <typename Id, typename W>
+basic_csr_graph<Id, W> basic_csr_graph<Id, W>::from_edges(size_t n, std::vector<edge_t> const& edges, bool undirected)
+{
+	id_check(n);
+	auto ret = basic_csr_graph();
+	ret.offset.assign(n + 1, 0);
+	for (auto const& e : edges) {
+		if (std::get<1>(e) >= n || std::get<2>(e) >= n) {
+			throw std::out_of_range("Graph bound check failed");
+		}
+		++ret.offset[std::get<1>(e) + 1];
+		if (undirected) {
+			++ret.offset[std::get<2>(e) + 1];
+		}
+	}
+	for (size_t i = 0; i != n; ++i) {
+		ret.offset[i + 1] += ret.offset[i];
+	}
+	ret.target.resize(ret.offset[n]);
+	ret.weight.resize(ret.offset[n]);
+	auto pos = std::vector<size_t>(ret.offset.begin(), ret.offset.end() - 1);
+	for (auto const& e : edges) {
+		auto k = pos[std::get<1>(e)]++;
+		ret.target[k] = static_cast<Id>(std::get<2>(e));
+		ret.weight[k] = std::get<0>(e);
+		if (undirected) {
+			k = pos[std::get<2>(e)]++;
+			ret.target[k] = static_cast<Id>(std::get<1>(e));
+			ret.weight[k] = std::get<0>(e);
+		}
+	}
+	return ret;
+}
+
+#ifdef sparse_matrix_defined
+template <typename Id, typename W>
+template <size_t N>
+basic_csr_graph<Id, W> basic_csr_graph<Id, W>::from_matrix(sparse_matrix2d<W, N, N> const& m)
+{
+	id_check(N);
+	auto ret = basic_csr_graph();
+	ret.offset.assign(N + 1, 0);
+	ret.target.reserve(m.size());
+	ret.weight.reserve(m.size());
+	for (auto const& x : m) {
+		++ret.offset[std::get<0>(x.first) + 1];
+		ret.target.push_back(static_cast<Id>(std::get<1>(x.first)));
+		ret.weight.push_back(x.second);
+	}
+	for (size_t i = 0; i != N; ++i) {
+		ret.offset[i + 1] += ret.offset[i];
+	}
+	return ret;
+}
+#endif
+
+template <typename Id, typename W>
+basic_csr_graph<Id, W> basic_csr_graph<Id, W>::reverse() const
+{
+	auto n = vertices();
+	auto ret = basic_csr_graph();
+	ret.offset.assign(n + 1, 0);
+	for (auto t : target) {
+		++ret.offset[static_cast<size_t>(t) + 1];
+	}
+	for (size_t i = 0; i != n; ++i) {
+		ret.offset[i + 1] += ret.offset[i];
+	}
+	ret.target.resize(target.size());
+	ret.weight.resize(weight.size());
+	auto pos = std::vector<size_t>(ret.offset.begin(), ret.offset.end() - 1);
+	for (size_t u = 0; u != n; ++u) {
+		for (auto k = offset[u]; k != offset[u + 1]; ++k) {
+			auto j = pos[static_cast<size_t>(target[k])]++;
+			ret.target[j] = static_cast<Id>(u);
+			ret.weight[j] = weight[k];
+		}
+	}
+	return ret;
+}
+
+template <typename Id, typename W>
+size_t basic_csr_graph<Id, W>::vertices() const noexcept
+{
+	return offset.size() - 1;
+}
+
+template <typename Id, typename W>
+size_t basic_csr_graph<Id, W>::edges() const noexcept
+{
+	return target.size();
+}
+
+template <typename Id, typename W>
+size_t basic_csr_graph<Id, W>::degree(size_t v) const noexcept
+{
+	return offset[v + 1] - offset[v];
+}
+
+template <typename Id, typename W>
+size_t basic_csr_graph<Id, W>::bytes() const noexcept
+{
+	return offset.size() * sizeof(size_t) + target.size() * sizeof(Id) + weight.size() * sizeof(W);
+}
+
+template <typename Id, typename W>
+std::vector<size_t> const& basic_csr_graph<Id, W>::offsets() const noexcept
+{
+	return offset;
+}
+
+template <typename Id, typename W>
+std::vector<Id> const& basic_csr_graph<Id, W>::targets() const noexcept
+{
+	return target;
+}
+
+template <typename Id, typename W>
+std::vector<W> const& basic_csr_graph<Id, W>::weights() const noexcept
+{
+	return weight;
+}
+
+#define CsrGraph_defined
+
+#endif
@@ -0,0 +1,316 @@
+#pragma once
+
+#ifndef CsrMatrix_disabled
+
+#ifndef CsrMatrix_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Semiring.hpp"
+#include "SparseMatrix.hpp"
+
+/// @brief 压缩行存储(CSR)的二维稀疏矩阵
+/// @details
+/// 只读的紧凑存储，按行连续存放列下标与值，适合SpMV/SpGEMM等批量运算
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+class csr_matrix
+{
+public:
+	//声明所有模版特化为友元类
+	template<typename, size_t, size_t> friend class csr_matrix;
+
+	//声明映射矩阵为友元类
+	template<typename, size_t, size_t> friend class mapped_csr_matrix;
+
+	/// 默认构造函数，构造空矩阵
+	csr_matrix();
+
+	/// @brief 由二维稀疏矩阵构造
+	/// @param m 源矩阵
+	explicit csr_matrix(sparse_matrix2d<T, DimA, DimB> const& m);
+
+private:
+
+	/// 行偏移，长度为DimA + 1
+	std::vector<size_t> ptr;
+
+	/// 列下标
+	std::vector<size_t> col;
+
+	/// 元素值
+	std::vector<T> val;
+
+public:
+
+	/// @brief 非零元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept;
+
+	/// @brief 行偏移数组
+	/// @return 长度为DimA + 1的行偏移
+	std::vector<size_t> const& row_ptr() const noexcept;
+
+	/// @brief 列下标数组
+	/// @return 列下标
+	std::vector<size_t> const& col_idx() const noexcept;
+
+	/// @brief 元素值数组
+	/// @return 元素值
+	std::vector<T> const& values() const noexcept;
+
+	/// @brief 动态边界检查的获取
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 按半环解释未存储元素的动态边界检查的获取
+	/// @details 半环乘积不存储等于zero的元素，读取Mul<S>的结果时应使用此重载，如min_plus下不可达为无穷大而非0
+	/// @return 值，未存储时为S::zero()
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	/// @tparam S 半环
+	template <typename S>
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 不带边界检查的矩阵向量乘 y = Ax
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	void spmv(T const* x, T* y) const noexcept;
+
+	/// @brief 按行块并行的矩阵向量乘 y = Ax，不带边界检查
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量
+	/// @param threads 线程数，为0时使用硬件并发数
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	void spmv(T const* x, T* y, size_t threads) const;
+
+	/// @brief 只计算行[b, e)的矩阵向量乘，不带边界检查
+	/// @details 供已有线程组的调用者按行划分后各自计算
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量，只写入行[b, e)
+	/// @param b 起始行
+	/// @param e 结束行
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	void spmv(T const* x, T* y, size_t b, size_t e) const noexcept;
+
+	/// @brief 矩阵向量乘
+	/// @return Ax
+	/// @param x 长度为DimB的输入向量
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	std::vector<T> spmv(std::vector<T> const& x) const;
+
+	/// @brief AxB与BxC的矩阵乘积(Gustavson算法)
+	/// @details 加法与乘法由半环给出，结果为半环zero的元素不会被存储
+	/// @return 乘积
+	/// @param m2 目标矩阵
+	/// @tparam S 半环，默认为普通加乘
+	/// @tparam DimC 矩阵2的列数
+	template <typename S = plus_times<T>, size_t DimC>
+	csr_matrix<T, DimA, DimC> Mul(csr_matrix<T, DimB, DimC> const& m2) const;
+
+	/// @brief 计数排序转置
+	/// @details 转置的CSR即为原矩阵的CSC(压缩列存储)，可用于按列访问
+	/// @return 转置
+	/// @param threads 线程数，为0时使用硬件并发数
+	csr_matrix<T, DimB, DimA> Rev(size_t threads = 1) const;
+
+	/// @brief 转换为二维稀疏矩阵
+	/// @return 二维稀疏矩阵
+	sparse_matrix2d<T, DimA, DimB> to_sparse() const;
+};
+
+template <typename T, size_t DimA, size_t DimB>
+csr_matrix<T, DimA, DimB>::csr_matrix() : ptr(DimA + 1)
+{ }
+
+template <typename T, size_t DimA, size_t DimB>
+csr_matrix<T, DimA, DimB>::csr_matrix(sparse_matrix2d<T, DimA, DimB> const& m) : ptr(DimA + 1)
+{
+	col.reserve(m.size());
+	val.reserve(m.size());
+	for (auto const& ele : m) {
+		++ptr[std::get<0>(ele.first) + 1];
+		col.push_back(std::get<1>(ele.first));
+		val.push_back(ele.second);
+	}
+	for (size_t i = 0; i != DimA; ++i) {
+		ptr[i + 1] += ptr[i];
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t csr_matrix<T, DimA, DimB>::size() const noexcept
+{
+	return val.size();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::vector<size_t> const& csr_matrix<T, DimA, DimB>::row_ptr() const noexcept
+{
+	return ptr;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::vector<size_t> const& csr_matrix<T, DimA, DimB>::col_idx() const noexcept
+{
+	return col;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::vector<T> const& csr_matrix<T, DimA, DimB>::values() const noexcept
+{
+	return val;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+T csr_matrix<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	return get<plus_times<T>>(DimAg, DimBg);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+T csr_matrix<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	if (DimA <= DimAg || DimB <= DimBg) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	auto b = col.begin() + ptr[DimAg];
+	auto e = col.begin() + ptr[DimAg + 1];
+	auto it = std::lower_bound(b, e, DimBg);
+	if (it != e && *it == DimBg) {
+		return val[it - col.begin()];
+	}
+	return S::zero();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+void csr_matrix<T, DimA, DimB>::spmv(T const* x, T* y) const noexcept
+{
+	spmv<S>(x, y, 0, DimA);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+void csr_matrix<T, DimA, DimB>::spmv(T const* x, T* y, size_t threads) const
+{
+	parallel_for(DimA, threads, [this, x, y](size_t, size_t b, size_t e) {
+		spmv<S>(x, y, b, e);
+	});
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+void csr_matrix<T, DimA, DimB>::spmv(T const* x, T* y, size_t b, size_t e) const noexcept
+{
+	for (auto i = b; i != e; ++i) {
+		T a = S::zero();
+		for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+			a = S::add(a, S::mul(val[k], x[col[k]]));
+		}
+		y[i] = a;
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+std::vector<T> csr_matrix<T, DimA, DimB>::spmv(std::vector<T> const& x) const
+{
+	if (x.size() != DimB) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto y = std::vector<T>(DimA);
+	spmv<S>(x.data(), y.data());
+	return y;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S, size_t DimC>
+csr_matrix<T, DimA, DimC> csr_matrix<T, DimA, DimB>::Mul(csr_matrix<T, DimB, DimC> const& m2) const
+{
+	csr_matrix<T, DimA, DimC> res;
+	auto acc = std::vector<T>(DimC);
+	auto mark = std::vector<size_t>(DimC, DimA);
+	auto cols = std::vector<size_t>();
+	for (size_t i = 0; i != DimA; ++i) {
+		cols.clear();
+		for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+			auto r = col[k];
+			for (auto l = m2.ptr[r]; l != m2.ptr[r + 1]; ++l) {
+				auto c = m2.col[l];
+				if (mark[c] != i) {
+					mark[c] = i;
+					acc[c] = S::mul(val[k], m2.val[l]);
+					cols.push_back(c);
+				} else {
+					acc[c] = S::add(acc[c], S::mul(val[k], m2.val[l]));
+				}
+			}
+		}
+		std::sort(cols.begin(), cols.end());
+		for (auto c : cols) {
+			if (acc[c] != S::zero()) {
+				res.col.push_back(c);
+				res.val.push_back(acc[c]);
+			}
+		}
+		res.ptr[i + 1] = res.col.size();
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+csr_matrix<T, DimB, DimA> csr_matrix<T, DimA, DimB>::Rev(size_t threads) const
+{
+	csr_matrix<T, DimB, DimA> res;
+	auto rows = std::vector<size_t>(col.size());
+	for (size_t i = 0; i != DimA; ++i) {
+		std::fill(rows.begin() + ptr[i], rows.begin() + ptr[i + 1], i);
+	}
+	auto order = transpose_order(col, DimB, threads);
+	for (auto c : col) {
+		++res.ptr[c + 1];
+	}
+	for (size_t j = 0; j != DimB; ++j) {
+		res.ptr[j + 1] += res.ptr[j];
+	}
+	res.col.resize(col.size());
+	res.val.resize(val.size());
+	parallel_for(order.size(), threads, [this, &res, &rows, &order](size_t, size_t b, size_t e) {
+		for (auto k = b; k != e; ++k) {
+			res.col[k] = rows[order[k]];
+			res.val[k] = val[order[k]];
+		}
+	});
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> csr_matrix<T, DimA, DimB>::to_sparse() const
+{
+	sparse_matrix2d<T, DimA, DimB> res;
+	for (size_t i = 0; i != DimA; ++i) {
+		for (auto k = ptr[i]; k != ptr[i + 1]; ++k) {
+			res.push_back_unchecked(val[k], i, col[k]);
+		}
+	}
+	return res;
+}
+
+#define CsrMatrix_defined
+
+#endif
+
+#endif
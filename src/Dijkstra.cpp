@@ -1,6 +1,8 @@
 #include <limits>
 #include <queue>
 #include <functional>
+#include <algorithm>
+#include "Parallel.hpp"
 #include "Dijkstra.h"
 
 #ifdef Dijkstra_defined
@@ -19,9 +21,9 @@ std::vector<int> dijkstra(std::vector<std::vector<std::pair<size_t, int>>> const
 		{
 			auto next_step = m[current_step][i].first;
 			auto next_length = m[current_step][i].second;
-			if (d[next_step] > d[current_step] + next_length)
+			if (d[next_step] > path_weight<int>::add(d[current_step], next_length))
 			{
-				d[next_step] = d[current_step] + next_length;
+				d[next_step] = path_weight<int>::add(d[current_step], next_length);
 				q.push(std::make_pair(d[next_step], next_step));
 			}
 		}
@@ -29,4 +31,158 @@ std::vector<int> dijkstra(std::vector<std::vector<std::pair<size_t, int>>> const
 	return d;
 }
 
+std::vector<int> dijkstra(csr_graph const& g, size_t s)
+{
+	return dijkstra<lazy_binary_heap>(g, s);
+}
+
+std::vector<int> dijkstra(csr_graph32 const& g, size_t s)
+{
+	return dijkstra<lazy_binary_heap>(g, s);
+}
+
+std::vector<int> delta_stepping(std::vector<std::vector<std::pair<size_t, int>>> const& m, size_t s, int delta, size_t threads)
+{
+	const auto inf = std::numeric_limits<int>::max();
+	const auto none = std::numeric_limits<size_t>::max();
+	auto n = m.size();
+	auto d = std::vector<int>(n, inf);
+	size_t edges = 0;
+	int max_w = 1;
+	for (auto const& adj : m) {
+		edges += adj.size();
+		for (auto const& e : adj) {
+			max_w = std::max(max_w, e.second);
+		}
+	}
+	if (delta <= 0) {
+		delta = std::max(1, static_cast<int>(max_w / std::max<size_t>(1, edges / std::max<size_t>(1, n))));
+	}
+
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n));
+	auto size = std::min(static_cast<size_t>(max_w / delta) + 1, n / t + 1);
+	auto stamp = std::vector<size_t>(n, 0);
+	auto requests = std::vector<std::vector<std::vector<std::pair<size_t, int>>>>(t, std::vector<std::vector<std::pair<size_t, int>>>(t));
+	auto active = std::vector<unsigned char>(t, 0);
+	auto next = std::vector<size_t>(t, none);
+	d[s] = 0;
+
+	parallel_team(t, [&](size_t p, parallel_barrier& sync) {
+		auto buckets = std::vector<std::vector<size_t>>(size);
+		auto overflow = std::vector<size_t>();
+		auto overflow_min = none;
+		auto frontier = std::vector<size_t>();
+		auto settled = std::vector<size_t>();
+		size_t pending = 0;
+		size_t cursor = 0;
+		size_t round = 0;
+		size_t i = 0;
+
+		auto push = [&](size_t v, size_t b) {
+			buckets[b % size].push_back(v);
+			cursor = pending == 0 ? b : std::min(cursor, b);
+			++pending;
+		};
+		auto place = [&](size_t v) {
+			auto b = static_cast<size_t>(d[v] / delta);
+			if (b < i + size) {
+				push(v, b);
+			} else {
+				overflow.push_back(v);
+				overflow_min = std::min(overflow_min, b);
+			}
+		};
+		auto generate = [&](std::vector<size_t> const& from, bool light) {
+			auto& out = requests[p];
+			for (auto u : from) {
+				for (auto const& e : m[u]) {
+					if ((e.second <= delta) == light && d[u] <= inf - e.second) {
+						out[e.first % t].emplace_back(e.first, d[u] + e.second);
+					}
+				}
+			}
+		};
+		auto apply = [&] {
+			for (auto& out : requests) {
+				for (auto const& r : out[p]) {
+					if (r.second < d[r.first]) {
+						d[r.first] = r.second;
+						place(r.first);
+					}
+				}
+				out[p].clear();
+			}
+		};
+
+		if (s % t == p) {
+			place(s);
+		}
+		for (;;) {
+			if (overflow_min < i + size) {
+				auto rest = size_t(0);
+				overflow_min = none;
+				for (auto v : overflow) {
+					auto b = static_cast<size_t>(d[v] / delta);
+					if (b < i) {
+						continue;
+					}
+					if (b < i + size) {
+						push(v, b);
+					} else {
+						overflow[rest++] = v;
+						overflow_min = std::min(overflow_min, b);
+					}
+				}
+				overflow.resize(rest);
+			}
+
+			auto& bucket = buckets[i % size];
+			settled.clear();
+			for (;;) {
+				frontier.clear();
+				++round;
+				for (auto v : bucket) {
+					if (static_cast<size_t>(d[v] / delta) == i && stamp[v] != round) {
+						stamp[v] = round;
+						frontier.push_back(v);
+					}
+				}
+				pending -= bucket.size();
+				bucket.clear();
+				settled.insert(settled.end(), frontier.begin(), frontier.end());
+				generate(frontier, true);
+				sync.wait();
+				apply();
+				active[p] = bucket.empty() ? 0 : 1;
+				sync.wait();
+				if (std::find(active.begin(), active.end(), 1) == active.end()) {
+					break;
+				}
+			}
+
+			std::sort(settled.begin(), settled.end());
+			settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+			generate(settled, false);
+			sync.wait();
+			apply();
+			next[p] = overflow_min;
+			if (pending != 0) {
+				auto b = std::max(cursor, i + 1);
+				while (buckets[b % size].empty()) {
+					++b;
+				}
+				cursor = b;
+				next[p] = std::min(next[p], b);
+			}
+			sync.wait();
+			auto j = *std::min_element(next.begin(), next.end());
+			if (j == none) {
+				break;
+			}
+			i = j;
+		}
+	});
+	return d;
+}
+
 #endif
\ No newline at end of file
@@ -4,25 +4,563 @@
 
 #ifndef Dijkstra_defined
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
 #include <vector>
 #include "SparseMatrix.hpp"
+#include "CsrGraph.hpp"
+#include "PriorityQueue.hpp"
+#include "Parallel.hpp"
+
+/**
+ * \brief 最短路的边权运算
+ * \details 整数距离相加时饱和到最大值，浮点距离溢出时自然得到无穷大，最大值或无穷大即表示不可达
+ * \tparam W 边权类型
+ */
+template <typename W, bool = std::is_integral<W>::value>
+struct path_weight
+{
+	/**
+	 * \brief 不可达的距离
+	 * \return 无穷大
+	 */
+	static constexpr W unreachable() noexcept { return std::numeric_limits<W>::infinity(); }
+
+	/**
+	 * \brief 距离加边权
+	 * \param d 有限的距离
+	 * \param w 非负边权
+	 * \return d + w
+	 */
+	static constexpr W add(W d, W w) noexcept { return d + w; }
+};
+
+/**
+ * \brief 整数边权的特化
+ * \tparam W 边权类型
+ */
+template <typename W>
+struct path_weight<W, true>
+{
+	/**
+	 * \brief 不可达的距离
+	 * \return W的最大值
+	 */
+	static constexpr W unreachable() noexcept { return std::numeric_limits<W>::max(); }
+
+	/**
+	 * \brief 饱和的距离加边权
+	 * \param d 非负的距离
+	 * \param w 非负边权
+	 * \return d + w，溢出时为W的最大值
+	 */
+	static constexpr W add(W d, W w) noexcept { return w > std::numeric_limits<W>::max() - d ? std::numeric_limits<W>::max() : d + w; }
+};
 
 std::vector<int> dijkstra(std::vector<std::vector<std::pair<size_t, int>>> const& m, size_t s);
 
+/**
+ * \brief CSR图上的dijkstra
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \return 各点的最短距离，不可达为int最大值
+ */
+std::vector<int> dijkstra(csr_graph const& g, size_t s);
+
+/**
+ * \brief 32位顶点编号CSR图上的dijkstra
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \return 各点的最短距离，不可达为int最大值
+ */
+std::vector<int> dijkstra(csr_graph32 const& g, size_t s);
+
+/**
+ * \brief 指定优先队列策略的dijkstra
+ * \details 以dijkstra<radix_heap>(g, s)的形式调用，不带模板实参时使用惰性二叉堆
+ * \tparam Q 优先队列策略，见PriorityQueue.hpp
+ * \tparam Id 顶点编号类型
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \return 各点的最短距离，不可达为int最大值
+ */
+template <typename Q, typename Id>
+std::vector<int> dijkstra(basic_csr_graph<Id, int> const& g, size_t s)
+{
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	auto q = Q(g.vertices());
+	auto d = std::vector<int>(g.vertices(), std::numeric_limits<int>::max());
+	q.push(s, 0);
+	d[s] = 0;
+	while (!q.empty()) {
+		auto c = q.pop();
+		auto u = c.second;
+		if (c.first != d[u]) { continue; }
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = static_cast<size_t>(targets[k]);
+			auto nd = path_weight<int>::add(d[u], weights[k]);
+			if (nd < d[v]) {
+				d[v] = nd;
+				q.push(v, nd);
+			}
+		}
+	}
+	return d;
+}
+
+/**
+ * \brief 任意边权类型的dijkstra
+ * \details 整数距离饱和相加，不会因溢出得到负距离，达到最大值的距离视为不可达
+ * \tparam Id 顶点编号类型
+ * \tparam W 边权类型，如int、int64_t、float、double
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \return 各点的最短距离，不可达为path_weight<W>::unreachable()
+ */
+template <typename Id, typename W>
+std::vector<W> dijkstra(basic_csr_graph<Id, W> const& g, size_t s)
+{
+	using pw = path_weight<W>;
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	auto q = std::priority_queue<std::pair<W, size_t>, std::vector<std::pair<W, size_t>>, std::greater<>>();
+	auto d = std::vector<W>(g.vertices(), pw::unreachable());
+	q.emplace(W(), s);
+	d[s] = W();
+	while (!q.empty()) {
+		auto c = q.top(); q.pop();
+		auto u = c.second;
+		if (c.first != d[u]) { continue; }
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = static_cast<size_t>(targets[k]);
+			auto nd = pw::add(c.first, weights[k]);
+			if (nd < d[v]) {
+				d[v] = nd;
+				q.emplace(nd, v);
+			}
+		}
+	}
+	return d;
+}
+
+/**
+ * \brief delta-stepping单源最短路，结果与dijkstra相同
+ * \details
+ * 距离按宽度delta分桶，依次处理各桶：桶内反复松弛轻边(w <= delta)直到桶为空，再一次性松弛重边。
+ * 顶点按编号对线程数取模划分给常驻的工作线程，各线程为自己的顶点维护循环桶数组，
+ * 并行生成松弛请求后按终点所属线程分发，由所属线程并行应用；
+ * 桶数为最大边权除以delta加1，且不超过每线程的顶点数加1，超出窗口的顶点暂存于溢出表，窗口推进到时再移入
+ * \param m 邻接表，边权需非负
+ * \param s 起点
+ * \param delta 桶宽度，为0时取最大边权除以平均度数
+ * \param threads 线程数，为0时使用硬件并发数
+ * \return 各点的最短距离，不可达为int最大值
+ */
+std::vector<int> delta_stepping(std::vector<std::vector<std::pair<size_t, int>>> const& m, size_t s, int delta = 0, size_t threads = 0);
+
 template<size_t N>
 std::array<int, N> dijkstra(sparse_matrix2d<int, N, N> const& map, size_t s)
+{
+	auto x = dijkstra(csr_graph::from_matrix(map), s);
+	auto ret = std::array<int, N>();
+	std::copy(x.begin(), x.end(), ret.begin());
+	return ret;
+}
+
+template<size_t N>
+std::array<int, N> delta_stepping(sparse_matrix2d<int, N, N> const& map, size_t s, int delta = 0, size_t threads = 0)
 {
 	auto m = std::vector<std::vector<std::pair<size_t, int>>>();
+	m.reserve(N);
 	for(auto i = 0; i != N ;++i) {
 		m.emplace_back(map.row(i));
 	}
-	auto x =  dijkstra(m, s);
+	auto x = delta_stepping(m, s, delta, threads);
 	auto ret = std::array<int, N>();
 	std::copy(x.begin(), x.end(), ret.begin());
 	return ret;
 }
 
+/**
+ * \brief 可重复使用的dijkstra工作区
+ * \details
+ * 保存距离、前驱与堆，距离以代数标记有效性，每次查询只需递增代数而无需O(V)清空。
+ * 连续对同一张图做大量查询时复用同一个工作区，可避免每次分配距离数组与堆
+ */
+class dijkstra_workspace
+{
+	/// 距离
+	std::vector<int> dist;
+
+	/// 前驱
+	std::vector<size_t> pred;
+
+	/// 距离所属的代数，与generation不同的距离视为不可达
+	std::vector<std::uint32_t> stamp;
+
+	/// 当前代数
+	std::uint32_t generation = 0;
+
+	/// 惰性二叉堆
+	std::vector<std::pair<int, size_t>> heap;
+
+public:
+	/**
+	 * \brief 构造工作区
+	 * \param n 顶点数，不足时reset会自动扩展
+	 */
+	explicit dijkstra_workspace(size_t n = 0) : dist(n), pred(n), stamp(n, 0) { }
+
+	/**
+	 * \brief 开始新的查询，清空堆并使所有距离失效
+	 * \param n 图的顶点数
+	 */
+	void reset(size_t n)
+	{
+		if (stamp.size() < n) {
+			dist.resize(n);
+			pred.resize(n);
+			stamp.resize(n, generation);
+		}
+		if (++generation == 0) {
+			std::fill(stamp.begin(), stamp.end(), 0);
+			generation = 1;
+		}
+		heap.clear();
+	}
+
+	/**
+	 * \brief 本次查询中是否到达了顶点
+	 * \param v 顶点
+	 * \return 到达时返回真
+	 */
+	bool reached(size_t v) const noexcept { return stamp[v] == generation; }
+
+	/**
+	 * \brief 本次查询中到顶点的距离
+	 * \param v 顶点
+	 * \return 距离，未到达为int最大值
+	 */
+	int distance(size_t v) const noexcept { return reached(v) ? dist[v] : std::numeric_limits<int>::max(); }
+
+	/**
+	 * \brief 顶点的前驱，仅在reached(v)时有效
+	 * \param v 顶点
+	 * \return 前驱，起点的前驱为自身
+	 */
+	size_t predecessor(size_t v) const noexcept { return pred[v]; }
+
+	/**
+	 * \brief 设置距离与前驱
+	 * \param v 顶点
+	 * \param d 距离
+	 * \param p 前驱
+	 */
+	void set(size_t v, int d, size_t p) noexcept
+	{
+		dist[v] = d;
+		pred[v] = p;
+		stamp[v] = generation;
+	}
+
+	/**
+	 * \brief 由前驱还原路径
+	 * \param t 终点，需在本次查询中到达
+	 * \return 从起点到t的顶点序列
+	 */
+	std::vector<size_t> path(size_t t) const
+	{
+		auto ret = std::vector<size_t>{ t };
+		while (pred[t] != t) {
+			t = pred[t];
+			ret.push_back(t);
+		}
+		std::reverse(ret.begin(), ret.end());
+		return ret;
+	}
+
+	/**
+	 * \brief 堆是否为空
+	 * \return 为空时返回真
+	 */
+	bool empty() const noexcept { return heap.empty(); }
+
+	/**
+	 * \brief 堆顶
+	 * \return (键, 顶点)
+	 */
+	std::pair<int, size_t> const& top() const noexcept { return heap.front(); }
+
+	/**
+	 * \brief 插入堆条目
+	 * \param v 顶点
+	 * \param key 键
+	 */
+	void push(size_t v, int key)
+	{
+		heap.emplace_back(key, v);
+		std::push_heap(heap.begin(), heap.end(), std::greater<>());
+	}
+
+	/**
+	 * \brief 弹出堆顶
+	 * \return (键, 顶点)
+	 */
+	std::pair<int, size_t> pop()
+	{
+		std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+		auto ret = heap.back();
+		heap.pop_back();
+		return ret;
+	}
+};
+
+/**
+ * \brief 使用工作区的dijkstra，结果通过ws.distance与ws.path读取
+ * \tparam Id 顶点编号类型
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \param ws 工作区
+ */
+template <typename Id>
+void dijkstra(basic_csr_graph<Id, int> const& g, size_t s, dijkstra_workspace& ws)
+{
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	ws.reset(g.vertices());
+	ws.set(s, 0, s);
+	ws.push(s, 0);
+	while (!ws.empty()) {
+		auto c = ws.pop();
+		auto u = c.second;
+		if (c.first != ws.distance(u)) { continue; }
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = static_cast<size_t>(targets[k]);
+			auto nd = path_weight<int>::add(c.first, weights[k]);
+			if (nd < ws.distance(v)) {
+				ws.set(v, nd, u);
+				ws.push(v, nd);
+			}
+		}
+	}
+}
+
+/**
+ * \brief 多起点批量dijkstra
+ * \details 起点由多个线程动态领取，每个线程拥有一个工作区，每个起点计算完成后以(起点下标, 工作区)调用f
+ * \tparam Id 顶点编号类型
+ * \tparam F 回调类型，会在多个线程中并发调用
+ * \param g 图，边权需非负
+ * \param sources 起点
+ * \param f 回调，工作区只在本次调用内有效
+ * \param threads 线程数，为0时使用硬件并发数
+ */
+template <typename Id, typename F>
+void dijkstra_batch(basic_csr_graph<Id, int> const& g, std::vector<size_t> const& sources, F&& f, size_t threads = 0)
+{
+	auto next = std::atomic<size_t>(0);
+	parallel_for(sources.size(), threads, [&](size_t, size_t, size_t) {
+		auto ws = dijkstra_workspace(g.vertices());
+		for (auto i = next++; i < sources.size(); i = next++) {
+			dijkstra(g, sources[i], ws);
+			f(i, static_cast<dijkstra_workspace const&>(ws));
+		}
+	});
+}
+
+/**
+ * \brief 点对点最短路的结果
+ */
+struct shortest_path_result
+{
+	/// 最短距离，不可达为int最大值
+	int distance;
+
+	/// 从起点到终点的顶点序列，不可达时为空
+	std::vector<size_t> path;
+};
+
+/**
+ * \brief 使用工作区的双向dijkstra点对点最短路
+ * \details
+ * 从s沿g正向、从t沿rg反向交替扩展较小的一侧，两侧堆顶之和不小于已知最短路时停止，
+ * 只访问两端附近的顶点而不计算到所有顶点的距离
+ * \tparam Id 顶点编号类型
+ * \param g 图，边权需非负
+ * \param rg g的反向图(g.reverse())，无向图可直接传入g
+ * \param s 起点
+ * \param t 终点
+ * \param fw 正向搜索的工作区
+ * \param bw 反向搜索的工作区
+ * \return 最短距离与路径
+ */
+template <typename Id>
+shortest_path_result shortest_path(basic_csr_graph<Id, int> const& g, basic_csr_graph<Id, int> const& rg, size_t s, size_t t,
+	dijkstra_workspace& fw, dijkstra_workspace& bw)
+{
+	const auto inf = std::numeric_limits<int>::max();
+	auto n = g.vertices();
+	if (s >= n || t >= n || rg.vertices() != n) {
+		throw std::out_of_range("Graph bound check failed");
+	}
+	if (s == t) {
+		return shortest_path_result{ 0, { s } };
+	}
+	basic_csr_graph<Id, int> const* graph[2] = { &g, &rg };
+	dijkstra_workspace* ws[2] = { &fw, &bw };
+	auto best = inf;
+	auto meet = n;
+	fw.reset(n);
+	bw.reset(n);
+	fw.set(s, 0, s);
+	bw.set(t, 0, t);
+	fw.push(s, 0);
+	bw.push(t, 0);
+	for (;;) {
+		for (auto w : ws) {
+			while (!w->empty() && w->top().first != w->distance(w->top().second)) {
+				w->pop();
+			}
+		}
+		if (fw.empty() || bw.empty() || fw.top().first >= best - bw.top().first) {
+			break;
+		}
+		auto x = fw.top().first <= bw.top().first ? 0 : 1;
+		auto& a = *ws[x];
+		auto& b = *ws[1 - x];
+		auto c = a.pop();
+		auto u = c.second;
+		auto const& offsets = graph[x]->offsets();
+		auto const& targets = graph[x]->targets();
+		auto const& weights = graph[x]->weights();
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = static_cast<size_t>(targets[k]);
+			auto nd = path_weight<int>::add(c.first, weights[k]);
+			if (nd < a.distance(v)) {
+				a.set(v, nd, u);
+				a.push(v, nd);
+			}
+			if (b.reached(v) && nd < best - b.distance(v)) {
+				best = nd + b.distance(v);
+				meet = v;
+			}
+		}
+	}
+	if (meet == n) {
+		return shortest_path_result{ inf, {} };
+	}
+	auto path = fw.path(meet);
+	for (auto v = meet; v != t;) {
+		v = bw.predecessor(v);
+		path.push_back(v);
+	}
+	return shortest_path_result{ best, std::move(path) };
+}
+
+/**
+ * \brief 双向dijkstra点对点最短路，每次调用分配新的工作区
+ * \tparam Id 顶点编号类型
+ * \param g 图，边权需非负
+ * \param rg g的反向图(g.reverse())，无向图可直接传入g
+ * \param s 起点
+ * \param t 终点
+ * \return 最短距离与路径
+ */
+template <typename Id>
+shortest_path_result shortest_path(basic_csr_graph<Id, int> const& g, basic_csr_graph<Id, int> const& rg, size_t s, size_t t)
+{
+	auto fw = dijkstra_workspace(g.vertices());
+	auto bw = dijkstra_workspace(g.vertices());
+	return shortest_path(g, rg, s, t, fw, bw);
+}
+
+/**
+ * \brief 无向图上的双向dijkstra点对点最短路
+ * \tparam Id 顶点编号类型
+ * \param g 无向图，每条边需双向存储，边权需非负
+ * \param s 起点
+ * \param t 终点
+ * \return 最短距离与路径
+ */
+template <typename Id>
+shortest_path_result shortest_path(basic_csr_graph<Id, int> const& g, size_t s, size_t t)
+{
+	return shortest_path(g, g, s, t);
+}
+
+/**
+ * \brief 使用工作区的A*点对点最短路
+ * \details 按d(v) + h(v)的顺序扩展，t出堆时停止。h(v)需不超过v到t的真实距离，满足一致性时每个顶点只扩展一次
+ * \tparam Id 顶点编号类型
+ * \tparam H 启发函数类型，以顶点调用返回int
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \param t 终点
+ * \param h 启发函数，h(t)应为0
+ * \param ws 工作区
+ * \return 最短距离与路径
+ */
+template <typename Id, typename H>
+shortest_path_result a_star(basic_csr_graph<Id, int> const& g, size_t s, size_t t, H&& h, dijkstra_workspace& ws)
+{
+	auto n = g.vertices();
+	if (s >= n || t >= n) {
+		throw std::out_of_range("Graph bound check failed");
+	}
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	ws.reset(n);
+	ws.set(s, 0, s);
+	ws.push(s, h(s));
+	while (!ws.empty()) {
+		auto c = ws.pop();
+		auto u = c.second;
+		auto du = ws.distance(u);
+		if (c.first != path_weight<int>::add(du, h(u))) { continue; }
+		if (u == t) {
+			return shortest_path_result{ du, ws.path(t) };
+		}
+		for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+			auto v = static_cast<size_t>(targets[k]);
+			auto nd = path_weight<int>::add(du, weights[k]);
+			if (nd < ws.distance(v)) {
+				ws.set(v, nd, u);
+				ws.push(v, path_weight<int>::add(nd, h(v)));
+			}
+		}
+	}
+	return shortest_path_result{ std::numeric_limits<int>::max(), {} };
+}
+
+/**
+ * \brief A*点对点最短路，每次调用分配新的工作区
+ * \tparam Id 顶点编号类型
+ * \tparam H 启发函数类型，以顶点调用返回int
+ * \param g 图，边权需非负
+ * \param s 起点
+ * \param t 终点
+ * \param h 启发函数，h(t)应为0
+ * \return 最短距离与路径
+ */
+template <typename Id, typename H>
+shortest_path_result a_star(basic_csr_graph<Id, int> const& g, size_t s, size_t t, H&& h)
+{
+	auto ws = dijkstra_workspace(g.vertices());
+	return a_star(g, s, t, std::forward<H>(h), ws);
+}
+
 #define Dijkstra_defined
 
 #endif
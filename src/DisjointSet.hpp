@@ -0,0 +1,179 @@
+#pragma once
+
+#ifndef DisjointSet_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <atomic>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+/// @brief 并查集，按秩合并与路径减半
+/// @details 查找与合并的均摊复杂度为O(α(n))，查找为迭代实现，不会因长链而栈溢出
+/// @tparam Id 元素编号类型，可取32位以减小内存占用
+template <typename Id = size_t>
+class disjoint_set
+{
+	/// 父节点，根的父节点为自身
+	std::vector<Id> parent;
+
+	/// 根的秩，不超过log2(n)
+	std::vector<unsigned char> rank;
+
+	/// 集合数
+	size_t count = 0;
+
+public:
+	/// @brief 构造n个单元素集合
+	/// @param n 元素数
+	explicit disjoint_set(size_t n = 0) : parent(n), rank(n, 0), count(n)
+	{
+		std::iota(parent.begin(), parent.end(), Id(0));
+	}
+
+	/// @brief 查找根并做路径减半
+	/// @return 根
+	/// @param x 元素
+	Id find(Id x) noexcept
+	{
+		while (parent[x] != x) {
+			x = parent[x] = parent[parent[x]];
+		}
+		return x;
+	}
+
+	/// @brief 只读地查找根，没有并发的修改时可在多个线程中调用
+	/// @return 根
+	/// @param x 元素
+	Id find(Id x) const noexcept
+	{
+		while (parent[x] != x) {
+			x = parent[x];
+		}
+		return x;
+	}
+
+	/// @brief 合并两个元素所在的集合，秩小的根连到秩大的根下
+	/// @return 原本不在同一集合时返回真
+	/// @param a 元素
+	/// @param b 元素
+	bool unite(Id a, Id b) noexcept
+	{
+		a = find(a);
+		b = find(b);
+		if (a == b) {
+			return false;
+		}
+		if (rank[a] < rank[b]) {
+			std::swap(a, b);
+		}
+		parent[b] = a;
+		if (rank[a] == rank[b]) {
+			++rank[a];
+		}
+		--count;
+		return true;
+	}
+
+	/// @brief 是否在同一集合
+	/// @return 在同一集合时返回真
+	/// @param a 元素
+	/// @param b 元素
+	bool same(Id a, Id b) noexcept { return find(a) == find(b); }
+
+	/// @brief 元素数
+	/// @return 元素数
+	size_t size() const noexcept { return parent.size(); }
+
+	/// @brief 集合数
+	/// @return 集合数
+	size_t sets() const noexcept { return count; }
+};
+
+/// @brief 无锁并发并查集
+/// @details
+/// 父节点为原子变量，合并以CAS将编号较小的根连到编号较大的根下，失败说明根已改变，重新查找后重试；
+/// 查找以CAS做路径减半，失败时忽略。按秩合并需要同时修改父节点与秩，无法以单个CAS完成，
+/// 因此按编号合并，编号随机时期望树高为O(log n)。find、unite与same可在多个线程中任意并发调用
+/// @tparam Id 元素编号类型
+template <typename Id = size_t>
+class concurrent_disjoint_set
+{
+	/// 父节点，根的父节点为自身
+	std::vector<std::atomic<Id>> parent;
+
+public:
+	/// @brief 构造n个单元素集合
+	/// @param n 元素数
+	explicit concurrent_disjoint_set(size_t n = 0) : parent(n)
+	{
+		for (size_t i = 0; i != n; ++i) {
+			parent[i].store(static_cast<Id>(i), std::memory_order_relaxed);
+		}
+	}
+
+	/// @brief 查找根并做路径减半
+	/// @return 查找时的根，并发合并时可能已不是根
+	/// @param x 元素
+	Id find(Id x) noexcept
+	{
+		for (;;) {
+			auto p = parent[x].load();
+			if (p == x) {
+				return x;
+			}
+			auto gp = parent[p].load();
+			if (p != gp) {
+				parent[x].compare_exchange_weak(p, gp);
+			}
+			x = gp;
+		}
+	}
+
+	/// @brief 合并两个元素所在的集合
+	/// @return 本次调用完成了合并时返回真，并发合并同一对集合时恰有一个调用返回真
+	/// @param a 元素
+	/// @param b 元素
+	bool unite(Id a, Id b) noexcept
+	{
+		for (;;) {
+			a = find(a);
+			b = find(b);
+			if (a == b) {
+				return false;
+			}
+			if (b < a) {
+				std::swap(a, b);
+			}
+			auto expected = a;
+			if (parent[a].compare_exchange_strong(expected, b)) {
+				return true;
+			}
+		}
+	}
+
+	/// @brief 是否在同一集合
+	/// @return 在同一集合时返回真
+	/// @param a 元素
+	/// @param b 元素
+	bool same(Id a, Id b) noexcept
+	{
+		for (;;) {
+			a = find(a);
+			b = find(b);
+			if (a == b) {
+				return true;
+			}
+			if (parent[a].load() == a) {
+				return false;
+			}
+		}
+	}
+
+	/// @brief 元素数
+	/// @return 元素数
+	size_t size() const noexcept { return parent.size(); }
+};
+
+#define DisjointSet_defined
+
+#endif
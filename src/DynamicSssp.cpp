@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include "DynamicSssp.h"
+
+#ifdef DynamicSssp_defined
+
+dynamic_sssp::dynamic_sssp(std::vector<std::vector<std::pair<size_t, int>>> const& m, size_t s) :
+	out(m.size()), in(m.size()), src(s)
+{
+	bound_check(s);
+	for (size_t u = 0; u != m.size(); ++u) {
+		for (auto const& e : m[u]) {
+			bound_check(e.first);
+			if (e.second < 0) {
+				throw std::out_of_range("Weight bound check failed");
+			}
+			auto k = find(u, e.first);
+			if (k == out[u].size()) {
+				out[u].emplace_back(e.first, e.second);
+			} else {
+				out[u][k].second = std::min(out[u][k].second, e.second);
+			}
+		}
+	}
+	init();
+}
+
+dynamic_sssp::dynamic_sssp(csr_graph const& g, size_t s) :
+	out(g.vertices()), in(g.vertices()), src(s)
+{
+	bound_check(s);
+	for (size_t u = 0; u != g.vertices(); ++u) {
+		for (auto k = g.offsets()[u]; k != g.offsets()[u + 1]; ++k) {
+			auto v = g.targets()[k];
+			if (g.weights()[k] < 0) {
+				throw std::out_of_range("Weight bound check failed");
+			}
+			auto j = find(u, v);
+			if (j == out[u].size()) {
+				out[u].emplace_back(v, g.weights()[k]);
+			} else {
+				out[u][j].second = std::min(out[u][j].second, g.weights()[k]);
+			}
+		}
+	}
+	init();
+}
+
+void dynamic_sssp::init()
+{
+	auto n = out.size();
+	for (size_t u = 0; u != n; ++u) {
+		for (auto const& e : out[u]) {
+			in[e.first].emplace_back(u, e.second);
+		}
+	}
+	dist.assign(n, std::numeric_limits<int>::max());
+	pred.assign(n, no_pred);
+	mark.assign(n, 0);
+	begin_update();
+	decrease(src, 0, src);
+}
+
+void dynamic_sssp::bound_check(size_t v) const
+{
+	if (v >= out.size()) {
+		throw std::out_of_range("Graph bound check failed");
+	}
+}
+
+void dynamic_sssp::begin_update()
+{
+	if (++generation == 0) {
+		std::fill(mark.begin(), mark.end(), 0);
+		generation = 1;
+	}
+	touched = 0;
+	heap.clear();
+}
+
+void dynamic_sssp::set(size_t v, int d, size_t p)
+{
+	dist[v] = d;
+	pred[v] = p;
+	if (mark[v] != generation) {
+		mark[v] = generation;
+		++touched;
+	}
+}
+
+void dynamic_sssp::push(size_t v, int d)
+{
+	heap.emplace_back(d, v);
+	std::push_heap(heap.begin(), heap.end(), std::greater<>());
+}
+
+void dynamic_sssp::propagate()
+{
+	while (!heap.empty()) {
+		std::pop_heap(heap.begin(), heap.end(), std::greater<>());
+		auto c = heap.back();
+		heap.pop_back();
+		auto u = c.second;
+		if (c.first != dist[u]) { continue; }
+		for (auto const& e : out[u]) {
+			auto nd = path_weight<int>::add(c.first, e.second);
+			if (nd < dist[e.first]) {
+				set(e.first, nd, u);
+				push(e.first, nd);
+			}
+		}
+	}
+}
+
+void dynamic_sssp::decrease(size_t v, int d, size_t p)
+{
+	if (d < dist[v]) {
+		set(v, d, p);
+		push(v, d);
+		propagate();
+	}
+}
+
+void dynamic_sssp::increase(size_t v)
+{
+	auto subtree = std::vector<size_t>{ v };
+	mark[v] = generation;
+	for (size_t i = 0; i != subtree.size(); ++i) {
+		auto x = subtree[i];
+		for (auto const& e : out[x]) {
+			if (pred[e.first] == x && mark[e.first] != generation) {
+				mark[e.first] = generation;
+				subtree.push_back(e.first);
+			}
+		}
+	}
+	touched = subtree.size();
+	for (auto x : subtree) {
+		dist[x] = std::numeric_limits<int>::max();
+		pred[x] = no_pred;
+	}
+	for (auto x : subtree) {
+		for (auto const& e : in[x]) {
+			auto nd = path_weight<int>::add(dist[e.first], e.second);
+			if (mark[e.first] != generation && nd < dist[x]) {
+				dist[x] = nd;
+				pred[x] = e.first;
+			}
+		}
+		if (pred[x] != no_pred) {
+			push(x, dist[x]);
+		}
+	}
+	propagate();
+}
+
+size_t dynamic_sssp::find(size_t u, size_t v) const noexcept
+{
+	size_t k = 0;
+	while (k != out[u].size() && out[u][k].first != v) {
+		++k;
+	}
+	return k;
+}
+
+void dynamic_sssp::update(size_t u, size_t v, int w)
+{
+	bound_check(u);
+	bound_check(v);
+	if (w < 0) {
+		throw std::out_of_range("Weight bound check failed");
+	}
+	begin_update();
+	auto k = find(u, v);
+	auto old = std::numeric_limits<int>::max();
+	if (k == out[u].size()) {
+		out[u].emplace_back(v, w);
+		in[v].emplace_back(u, w);
+	} else {
+		old = out[u][k].second;
+		out[u][k].second = w;
+		for (auto& e : in[v]) {
+			if (e.first == u) {
+				e.second = w;
+			}
+		}
+	}
+	if (u == v || dist[u] == std::numeric_limits<int>::max()) {
+		return;
+	}
+	if (w < old) {
+		decrease(v, path_weight<int>::add(dist[u], w), u);
+	} else if (w > old && pred[v] == u) {
+		increase(v);
+	}
+}
+
+bool dynamic_sssp::erase(size_t u, size_t v)
+{
+	bound_check(u);
+	bound_check(v);
+	begin_update();
+	auto k = find(u, v);
+	if (k == out[u].size()) {
+		return false;
+	}
+	out[u][k] = out[u].back();
+	out[u].pop_back();
+	for (auto& e : in[v]) {
+		if (e.first == u) {
+			e = in[v].back();
+			in[v].pop_back();
+			break;
+		}
+	}
+	if (u != v && pred[v] == u) {
+		increase(v);
+	}
+	return true;
+}
+
+int dynamic_sssp::weight(size_t u, size_t v) const
+{
+	bound_check(u);
+	bound_check(v);
+	auto k = find(u, v);
+	return k == out[u].size() ? std::numeric_limits<int>::max() : out[u][k].second;
+}
+
+std::vector<int> const& dynamic_sssp::distances() const noexcept
+{
+	return dist;
+}
+
+int dynamic_sssp::distance(size_t v) const
+{
+	bound_check(v);
+	return dist[v];
+}
+
+size_t dynamic_sssp::predecessor(size_t v) const
+{
+	bound_check(v);
+	return pred[v] == no_pred ? out.size() : pred[v];
+}
+
+std::vector<size_t> dynamic_sssp::path(size_t t) const
+{
+	bound_check(t);
+	if (pred[t] == no_pred) {
+		return {};
+	}
+	auto ret = std::vector<size_t>{ t };
+	while (pred[t] != t) {
+		t = pred[t];
+		ret.push_back(t);
+	}
+	std::reverse(ret.begin(), ret.end());
+	return ret;
+}
+
+size_t dynamic_sssp::source() const noexcept
+{
+	return src;
+}
+
+size_t dynamic_sssp::vertices() const noexcept
+{
+	return out.size();
+}
+
+size_t dynamic_sssp::last_affected() const noexcept
+{
+	return touched;
+}
+
+#endif
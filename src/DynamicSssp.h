@@ -0,0 +1,200 @@
+#pragma once
+
+#ifndef DynamicSssp_disabled
+
+#ifndef DynamicSssp_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "CsrGraph.hpp"
+#include "Dijkstra.h"
+
+/**
+ * \brief 边权动态变化时的单源最短路
+ * \details
+ * 保存到每个顶点的距离与最短路树(前驱)，边插入、删除或改权后只修复受影响的顶点：
+ * 边变短时从终点出发做只松弛变短距离的dijkstra；
+ * 树边变长或删除时先标记终点在最短路树中的子树，再由子树外的入边给出候选距离，在子树内重新做dijkstra。
+ * 非树边变长或删除不改变任何距离。每次更新的代价与受影响顶点的边数成正比，而非整张图
+ */
+class dynamic_sssp
+{
+	/// 不可达顶点的前驱
+	static constexpr size_t no_pred = static_cast<size_t>(-1);
+
+	/// 出边(终点, 边权)，每对顶点至多一条边
+	std::vector<std::vector<std::pair<size_t, int>>> out;
+
+	/// 入边(起点, 边权)
+	std::vector<std::vector<std::pair<size_t, int>>> in;
+
+	/// 起点
+	size_t src;
+
+	/// 距离，不可达为int最大值
+	std::vector<int> dist;
+
+	/// 前驱，起点的前驱为自身
+	std::vector<size_t> pred;
+
+	/// 本次更新中顶点的标记代数
+	std::vector<std::uint32_t> mark;
+
+	/// 当前代数
+	std::uint32_t generation = 0;
+
+	/// 本次更新修改过的顶点数
+	size_t touched = 0;
+
+	/// 惰性二叉堆
+	std::vector<std::pair<int, size_t>> heap;
+
+	/**
+	 * \brief 检查顶点编号
+	 * \param v 顶点
+	 */
+	void bound_check(size_t v) const;
+
+	/**
+	 * \brief 开始一次更新，使所有标记失效
+	 */
+	void begin_update();
+
+	/**
+	 * \brief 设置距离与前驱，并在本次更新中标记顶点
+	 * \param v 顶点
+	 * \param d 距离
+	 * \param p 前驱
+	 */
+	void set(size_t v, int d, size_t p);
+
+	/**
+	 * \brief 插入堆条目
+	 * \param v 顶点
+	 * \param d 距离
+	 */
+	void push(size_t v, int d);
+
+	/**
+	 * \brief 从堆中的顶点出发，只松弛能缩短距离的边
+	 */
+	void propagate();
+
+	/**
+	 * \brief 边p->v变短或插入后修复
+	 * \param v 终点
+	 * \param d 经过该边到v的距离
+	 * \param p 起点
+	 */
+	void decrease(size_t v, int d, size_t p);
+
+	/**
+	 * \brief 树边变长或删除后修复v的子树
+	 * \param v 该树边的终点
+	 */
+	void increase(size_t v);
+
+	/**
+	 * \brief 查找出边
+	 * \param u 起点
+	 * \param v 终点
+	 * \return 在out[u]中的下标，不存在时为out[u].size()
+	 */
+	size_t find(size_t u, size_t v) const noexcept;
+
+	/**
+	 * \brief 由去重后的边计算初始最短路
+	 */
+	void init();
+
+public:
+	/**
+	 * \brief 由dijkstra使用的邻接表构造，重边取最小边权
+	 * \param m 邻接表，边权需非负
+	 * \param s 起点
+	 */
+	dynamic_sssp(std::vector<std::vector<std::pair<size_t, int>>> const& m, size_t s);
+
+	/**
+	 * \brief 由CSR图构造，重边取最小边权
+	 * \param g 图，边权需非负
+	 * \param s 起点
+	 */
+	dynamic_sssp(csr_graph const& g, size_t s);
+
+	/**
+	 * \brief 插入边u->v，已存在时修改其边权
+	 * \param u 起点
+	 * \param v 终点
+	 * \param w 边权，需非负
+	 */
+	void update(size_t u, size_t v, int w);
+
+	/**
+	 * \brief 删除边u->v
+	 * \param u 起点
+	 * \param v 终点
+	 * \return 边存在并被删除时返回真
+	 */
+	bool erase(size_t u, size_t v);
+
+	/**
+	 * \brief 边权
+	 * \param u 起点
+	 * \param v 终点
+	 * \return 边权，不存在为int最大值
+	 */
+	int weight(size_t u, size_t v) const;
+
+	/**
+	 * \brief 到所有顶点的距离，与dijkstra的结果相同
+	 * \return 距离，不可达为int最大值
+	 */
+	std::vector<int> const& distances() const noexcept;
+
+	/**
+	 * \brief 到顶点的距离
+	 * \param v 顶点
+	 * \return 距离，不可达为int最大值
+	 */
+	int distance(size_t v) const;
+
+	/**
+	 * \brief 顶点在最短路树中的前驱
+	 * \param v 顶点
+	 * \return 前驱，起点为自身，不可达为顶点数
+	 */
+	size_t predecessor(size_t v) const;
+
+	/**
+	 * \brief 由最短路树还原路径
+	 * \param t 终点
+	 * \return 从起点到t的顶点序列，不可达时为空
+	 */
+	std::vector<size_t> path(size_t t) const;
+
+	/**
+	 * \brief 起点
+	 * \return 起点
+	 */
+	size_t source() const noexcept;
+
+	/**
+	 * \brief 顶点数
+	 * \return 顶点数
+	 */
+	size_t vertices() const noexcept;
+
+	/**
+	 * \brief 上一次更新修改了距离或前驱的顶点数
+	 * \return 顶点数
+	 */
+	size_t last_affected() const noexcept;
+};
+
+#define DynamicSssp_defined
+
+#endif
+
+#endif
@@ -0,0 +1,374 @@
+#pragma once
+
+#ifndef HybridMatrix_disabled
+
+#ifndef HybridMatrix_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "Semiring.hpp"
+#include "SparseMatrix.hpp"
+
+/// @brief 64位整数最低位1的下标
+/// @return 下标，x需非0
+/// @param x 整数
+inline unsigned hybrid_ctz(uint64_t x) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<unsigned>(__builtin_ctzll(x));
+#else
+	unsigned n = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		++n;
+	}
+	return n;
+#endif
+}
+
+/// @brief 按行自适应存储的二维稀疏矩阵
+/// @details
+/// 元素个数不少于阈值的行以位图加稠密数组存储，获取为O(1)；
+/// 其余行以CSR形式压缩存储。默认阈值为两种存储占用相等时的行元素个数，
+/// 适合度数服从幂律分布的邻接矩阵
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+class hybrid_matrix
+{
+public:
+	//声明所有模版特化为友元类
+	template<typename, size_t, size_t> friend class hybrid_matrix;
+
+	/// 位图每行的字数
+	static constexpr size_t words = (DimB + 63) / 64;
+
+	/// 默认稠密行阈值，稠密行占用不超过同样元素个数的压缩行
+	static constexpr size_t default_threshold = (DimB * sizeof(T) + words * sizeof(uint64_t) + sizeof(T) + sizeof(size_t) - 1) / (sizeof(T) + sizeof(size_t));
+
+	/// @brief 构造空矩阵
+	/// @param threshold 稠密行阈值
+	explicit hybrid_matrix(size_t threshold = default_threshold);
+
+	/// @brief 由二维稀疏矩阵构造
+	/// @param m 源矩阵
+	/// @param threshold 稠密行阈值
+	explicit hybrid_matrix(sparse_matrix2d<T, DimA, DimB> const& m, size_t threshold = default_threshold);
+
+private:
+
+	/// 稀疏行标记
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	/// 稠密行阈值
+	size_t threshold;
+
+	/// 压缩行的行偏移，长度为DimA + 1，稠密行的范围为空
+	std::vector<size_t> ptr;
+
+	/// 压缩行的列下标
+	std::vector<size_t> col;
+
+	/// 压缩行的元素值
+	std::vector<T> val;
+
+	/// 每行的稠密槽位，压缩行为npos
+	std::vector<size_t> slot;
+
+	/// 稠密行的占用位图，每槽位words个字
+	std::vector<uint64_t> bits;
+
+	/// 稠密行的元素值，每槽位DimB个
+	std::vector<T> dense;
+
+	/// 稠密行的元素个数
+	std::vector<size_t> dense_size;
+
+	/// @brief 按行号顺序追加一行，不带边界检查
+	/// @details 元素个数不少于阈值时存为稠密行
+	/// @param r 行号，需等于已追加的行数
+	/// @param cols 按升序排列的列下标
+	/// @param vals 对应的值
+	void push_row(size_t r, std::vector<size_t> const& cols, std::vector<T> const& vals);
+
+public:
+
+	/// @brief 按列升序遍历指定行，不带边界检查
+	/// @param r 行号
+	/// @param f 以(列号, 值)调用的函数
+	/// @tparam F 函数类型
+	template <typename F>
+	void for_row(size_t r, F&& f) const;
+
+	/// @brief 非零元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept;
+
+	/// @brief 稠密行个数
+	/// @return 稠密存储的行数
+	size_t dense_rows() const noexcept;
+
+	/// @brief 存储占用
+	/// @return 各数组占用的字节数
+	size_t bytes() const noexcept;
+
+	/// @brief 动态边界检查的行存储查询
+	/// @return 指定行是否稠密存储
+	/// @param r 行号
+	bool is_dense(size_t r) const;
+
+	/// @brief 动态边界检查的获取
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 动态边界检查获取指定行
+	/// @return 指定行
+	/// @param r 行号
+	std::vector<std::pair<size_t, T>> row(size_t r) const;
+
+	/// @brief 动态边界检查获取指定行的非零元素个数
+	/// @return 元素个数
+	/// @param r 行号
+	size_t row_size(size_t r) const;
+
+	/// @brief 不带边界检查的矩阵向量乘 y = Ax
+	/// @param x 长度为DimB的输入向量
+	/// @param y 长度为DimA的输出向量
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	void spmv(T const* x, T* y) const noexcept;
+
+	/// @brief 矩阵向量乘
+	/// @return Ax
+	/// @param x 长度为DimB的输入向量
+	/// @tparam S 半环，默认为普通加乘
+	template <typename S = plus_times<T>>
+	std::vector<T> spmv(std::vector<T> const& x) const;
+
+	/// @brief AxB与BxC的矩阵乘积(Gustavson算法)
+	/// @details 按阈值重新选择结果每行的存储，结果为半环zero的元素不会被存储
+	/// @return 乘积
+	/// @param m2 目标矩阵
+	/// @param threshold 结果的稠密行阈值
+	/// @tparam S 半环，默认为普通加乘
+	/// @tparam DimC 矩阵2的列数
+	template <typename S = plus_times<T>, size_t DimC>
+	hybrid_matrix<T, DimA, DimC> Mul(hybrid_matrix<T, DimB, DimC> const& m2, size_t threshold = hybrid_matrix<T, DimA, DimC>::default_threshold) const;
+
+	/// @brief 转换为二维稀疏矩阵
+	/// @return 二维稀疏矩阵
+	sparse_matrix2d<T, DimA, DimB> to_sparse() const;
+};
+
+template <typename T, size_t DimA, size_t DimB>
+hybrid_matrix<T, DimA, DimB>::hybrid_matrix(size_t threshold) : threshold(std::max<size_t>(threshold, 1)), ptr(DimA + 1), slot(DimA, npos)
+{ }
+
+template <typename T, size_t DimA, size_t DimB>
+hybrid_matrix<T, DimA, DimB>::hybrid_matrix(sparse_matrix2d<T, DimA, DimB> const& m, size_t threshold) : hybrid_matrix(threshold)
+{
+	auto cols = std::vector<size_t>();
+	auto vals = std::vector<T>();
+	size_t r = 0;
+	auto flush = [&](size_t next) {
+		for (; r != next; ++r) {
+			push_row(r, cols, vals);
+			cols.clear();
+			vals.clear();
+		}
+	};
+	for (auto const& ele : m) {
+		flush(std::get<0>(ele.first));
+		cols.push_back(std::get<1>(ele.first));
+		vals.push_back(ele.second);
+	}
+	flush(DimA);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void hybrid_matrix<T, DimA, DimB>::push_row(size_t r, std::vector<size_t> const& cols, std::vector<T> const& vals)
+{
+	if (cols.size() >= threshold) {
+		slot[r] = dense_size.size();
+		dense_size.push_back(cols.size());
+		bits.resize(bits.size() + words);
+		dense.resize(dense.size() + DimB);
+		auto b = bits.end() - words;
+		auto d = dense.end() - DimB;
+		for (size_t k = 0; k != cols.size(); ++k) {
+			b[cols[k] / 64] |= uint64_t(1) << (cols[k] % 64);
+			d[cols[k]] = vals[k];
+		}
+	} else {
+		col.insert(col.end(), cols.begin(), cols.end());
+		val.insert(val.end(), vals.begin(), vals.end());
+	}
+	ptr[r + 1] = col.size();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename F>
+void hybrid_matrix<T, DimA, DimB>::for_row(size_t r, F&& f) const
+{
+	if (slot[r] == npos) {
+		for (auto k = ptr[r]; k != ptr[r + 1]; ++k) {
+			f(col[k], val[k]);
+		}
+		return;
+	}
+	auto b = bits.data() + slot[r] * words;
+	auto d = dense.data() + slot[r] * DimB;
+	for (size_t w = 0; w != words; ++w) {
+		for (auto m = b[w]; m != 0; m &= m - 1) {
+			auto c = w * 64 + hybrid_ctz(m);
+			f(c, d[c]);
+		}
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t hybrid_matrix<T, DimA, DimB>::size() const noexcept
+{
+	auto n = col.size();
+	for (auto s : dense_size) {
+		n += s;
+	}
+	return n;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t hybrid_matrix<T, DimA, DimB>::dense_rows() const noexcept
+{
+	return dense_size.size();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t hybrid_matrix<T, DimA, DimB>::bytes() const noexcept
+{
+	return (ptr.size() + col.size() + slot.size() + dense_size.size()) * sizeof(size_t)
+		+ (val.size() + dense.size()) * sizeof(T) + bits.size() * sizeof(uint64_t);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+bool hybrid_matrix<T, DimA, DimB>::is_dense(size_t r) const
+{
+	if (DimA <= r) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	return slot[r] != npos;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+T hybrid_matrix<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	if (DimA <= DimAg || DimB <= DimBg) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	if (slot[DimAg] != npos) {
+		return dense[slot[DimAg] * DimB + DimBg];
+	}
+	auto b = col.begin() + ptr[DimAg];
+	auto e = col.begin() + ptr[DimAg + 1];
+	auto it = std::lower_bound(b, e, DimBg);
+	if (it != e && *it == DimBg) {
+		return val[it - col.begin()];
+	}
+	return T();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::vector<std::pair<size_t, T>> hybrid_matrix<T, DimA, DimB>::row(size_t r) const
+{
+	auto ret = std::vector<std::pair<size_t, T>>();
+	ret.reserve(row_size(r));
+	for_row(r, [&ret](size_t c, T v) { ret.emplace_back(c, v); });
+	return ret;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t hybrid_matrix<T, DimA, DimB>::row_size(size_t r) const
+{
+	if (DimA <= r) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	return slot[r] == npos ? ptr[r + 1] - ptr[r] : dense_size[slot[r]];
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+void hybrid_matrix<T, DimA, DimB>::spmv(T const* x, T* y) const noexcept
+{
+	for (size_t i = 0; i != DimA; ++i) {
+		T a = S::zero();
+		for_row(i, [&a, x](size_t c, T v) { a = S::add(a, S::mul(v, x[c])); });
+		y[i] = a;
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+std::vector<T> hybrid_matrix<T, DimA, DimB>::spmv(std::vector<T> const& x) const
+{
+	if (x.size() != DimB) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto y = std::vector<T>(DimA);
+	spmv<S>(x.data(), y.data());
+	return y;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S, size_t DimC>
+hybrid_matrix<T, DimA, DimC> hybrid_matrix<T, DimA, DimB>::Mul(hybrid_matrix<T, DimB, DimC> const& m2, size_t threshold) const
+{
+	hybrid_matrix<T, DimA, DimC> res(threshold);
+	auto acc = std::vector<T>(DimC);
+	auto mark = std::vector<size_t>(DimC, DimA);
+	auto cols = std::vector<size_t>();
+	auto vals = std::vector<T>();
+	for (size_t i = 0; i != DimA; ++i) {
+		cols.clear();
+		for_row(i, [&](size_t r, T a) {
+			m2.for_row(r, [&](size_t c, T b) {
+				if (mark[c] != i) {
+					mark[c] = i;
+					acc[c] = S::mul(a, b);
+					cols.push_back(c);
+				} else {
+					acc[c] = S::add(acc[c], S::mul(a, b));
+				}
+			});
+		});
+		std::sort(cols.begin(), cols.end());
+		cols.erase(std::remove_if(cols.begin(), cols.end(), [&acc](size_t c) { return acc[c] == S::zero(); }), cols.end());
+		vals.resize(cols.size());
+		for (size_t k = 0; k != cols.size(); ++k) {
+			vals[k] = acc[cols[k]];
+		}
+		res.push_row(i, cols, vals);
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> hybrid_matrix<T, DimA, DimB>::to_sparse() const
+{
+	sparse_matrix2d<T, DimA, DimB> res;
+	for (size_t i = 0; i != DimA; ++i) {
+		for_row(i, [&res, i](size_t c, T v) { res.set(v, i, c); });
+	}
+	return res;
+}
+
+#define HybridMatrix_defined
+
+#endif
+
+#endif
@@ -1,6 +1,12 @@
+#include <atomic>
+#include <cstdint>
 #include <numeric>
 #include <functional>
 #include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "DisjointSet.hpp"
+#include "Parallel.hpp"
 #include "Kruskal.h"
 
 
@@ -16,19 +22,297 @@ std::vector<std::tuple<int, size_t, size_t>> kruskal(std::vector<std::vector<std
 			d.emplace_back(std::get<1>(p), i, std::get<0>(p));
 		}
 	}
-	auto f = std::vector<size_t>(s);
-	std::function<size_t(size_t)> getb = [&f, &getb](size_t x) {return f[x] == x ? x : f[x] = getb(f[x]); };
-	iota(f.begin(), f.end(), 0);
+	auto f = disjoint_set<size_t>(s);
 	sort(d.begin(), d.end(), std::greater<>());
-	while(ans.size() != s- 1) {
+	while(!d.empty() && ans.size() + 1 < s) {
 		auto cur = d.back();
 		d.pop_back();
-		if(getb(std::get<1>(cur)) != getb(std::get<2>(cur))) {
-			f[getb(std::get<1>(cur))] = f[(std::get<2>(cur))];
+		if(f.unite(std::get<1>(cur), std::get<2>(cur))) {
 			ans.push_back(cur);
 		}
 	}
 	return ans;
 }
 
+template <typename G>
+static std::vector<std::tuple<int, size_t, size_t>> kruskal_csr(G const& g)
+{
+	using id_t = typename G::id_t;
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	auto n = g.vertices();
+	auto d = std::vector<std::tuple<int, id_t, id_t>>();
+	auto ans = std::vector<std::tuple<int, size_t, size_t>>();
+	d.reserve(g.edges() / 2);
+	for (size_t i = 0; i != n; ++i) {
+		for (auto k = offsets[i]; k != offsets[i + 1]; ++k) {
+			if (i < static_cast<size_t>(targets[k])) {
+				d.emplace_back(weights[k], static_cast<id_t>(i), targets[k]);
+			}
+		}
+	}
+	sort(d.begin(), d.end());
+	auto f = disjoint_set<id_t>(n);
+	for (auto const& cur : d) {
+		if (ans.size() + 1 >= n) {
+			break;
+		}
+		if (f.unite(std::get<1>(cur), std::get<2>(cur))) {
+			ans.emplace_back(std::get<0>(cur), std::get<1>(cur), std::get<2>(cur));
+		}
+	}
+	return ans;
+}
+
+std::vector<std::tuple<int, size_t, size_t>> kruskal(csr_graph const& g)
+{
+	return kruskal_csr(g);
+}
+
+std::vector<std::tuple<int, size_t, size_t>> kruskal(csr_graph32 const& g)
+{
+	return kruskal_csr(g);
+}
+
+/**
+ * \brief filter-Kruskal的并查集与结果
+ * \tparam Id 顶点编号类型
+ */
+template <typename Id>
+struct kruskal_forest
+{
+	/// 并查集
+	disjoint_set<Id> f;
+
+	/// 已选的边
+	std::vector<std::tuple<int, size_t, size_t>> ans;
+
+	/**
+	 * \brief 生成树是否已完成
+	 * \return 边数达到顶点数 - 1时返回真
+	 */
+	bool done() const noexcept
+	{
+		return ans.size() + 1 >= f.size();
+	}
+};
+
+/**
+ * \brief filter-Kruskal的递归部分，处理a[0, m)中的边，b为同样大小的临时空间
+ * \tparam Id 顶点编号类型
+ * \param s 并查集与结果
+ * \param a 边
+ * \param b 临时空间
+ * \param m 边数
+ * \param threads 线程数
+ */
+template <typename Id>
+static void filter_kruskal_range(kruskal_forest<Id>& s, std::tuple<int, Id, Id>* a, std::tuple<int, Id, Id>* b, size_t m,
+	size_t threads)
+{
+	using edge = std::tuple<int, Id, Id>;
+	if (s.done()) {
+		return;
+	}
+	auto light = m;
+	if (m > s.f.size() && m > 1024) {
+		auto sample = std::vector<edge>();
+		for (size_t i = 0; i != 31; ++i) {
+			sample.push_back(a[m * i / 31]);
+		}
+		std::nth_element(sample.begin(), sample.begin() + 15, sample.end());
+		auto pivot = sample[15];
+		light = parallel_partition_copy(a, a + m, b, [&pivot](edge const& e) { return !(pivot < e); }, threads);
+		if (light == m) {
+			std::copy(b, b + m, a);
+		}
+	}
+	if (light == m) {
+		parallel_sort(a, a + m, std::less<>(), threads);
+		for (size_t i = 0; i != m && !s.done(); ++i) {
+			if (s.f.unite(std::get<1>(a[i]), std::get<2>(a[i]))) {
+				s.ans.emplace_back(std::get<0>(a[i]), std::get<1>(a[i]), std::get<2>(a[i]));
+			}
+		}
+		return;
+	}
+	filter_kruskal_range(s, b, a, light, threads);
+	if (s.done()) {
+		return;
+	}
+	size_t kept;
+	if (parallel_threads(threads) == 1) {
+		kept = static_cast<size_t>(std::copy_if(b + light, b + m, a, [&s](edge const& e) {
+			return !s.f.same(std::get<1>(e), std::get<2>(e));
+		}) - a);
+	} else {
+		auto const& f = s.f;
+		kept = parallel_copy_if(b + light, b + m, a, [&f](edge const& e) {
+			return f.find(std::get<1>(e)) != f.find(std::get<2>(e));
+		}, threads);
+	}
+	filter_kruskal_range(s, a, b, kept, threads);
+}
+
+/**
+ * \brief 并行取出CSR图中起点小于终点的边
+ * \tparam G 图类型
+ * \param g 无向图，每条边需双向存储
+ * \param threads 线程数
+ * \return 边(权, 起点, 终点)，按起点升序
+ */
+template <typename G>
+static std::vector<std::tuple<int, typename G::id_t, typename G::id_t>> undirected_edges(G const& g, size_t threads)
+{
+	using id_t = typename G::id_t;
+	using edge = std::tuple<int, id_t, id_t>;
+	auto const& offsets = g.offsets();
+	auto const& targets = g.targets();
+	auto const& weights = g.weights();
+	auto n = g.vertices();
+	auto t = parallel_threads(threads);
+	auto count = std::vector<size_t>(t + 1, 0);
+	parallel_for(n, t, [&](size_t i, size_t b, size_t e) {
+		size_t c = 0;
+		for (auto u = b; u != e; ++u) {
+			for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+				c += u < static_cast<size_t>(targets[k]);
+			}
+		}
+		count[i + 1] = c;
+	});
+	for (size_t i = 0; i != t; ++i) {
+		count[i + 1] += count[i];
+	}
+	auto ret = std::vector<edge>(count[t]);
+	parallel_for(n, t, [&](size_t i, size_t lo, size_t hi) {
+		auto pos = count[i];
+		for (auto u = lo; u != hi; ++u) {
+			for (auto k = offsets[u]; k != offsets[u + 1]; ++k) {
+				if (u < static_cast<size_t>(targets[k])) {
+					ret[pos++] = edge(weights[k], static_cast<id_t>(u), targets[k]);
+				}
+			}
+		}
+	});
+	return ret;
+}
+
+template <typename G>
+static std::vector<std::tuple<int, size_t, size_t>> filter_kruskal_csr(G const& g, size_t threads)
+{
+	using id_t = typename G::id_t;
+	auto a = undirected_edges(g, threads);
+	auto b = decltype(a)(a.size());
+	auto s = kruskal_forest<id_t>{ disjoint_set<id_t>(g.vertices()), {} };
+	filter_kruskal_range(s, a.data(), b.data(), a.size(), threads);
+	return std::move(s.ans);
+}
+
+std::vector<std::tuple<int, size_t, size_t>> filter_kruskal(csr_graph const& g, size_t threads)
+{
+	return filter_kruskal_csr(g, threads);
+}
+
+std::vector<std::tuple<int, size_t, size_t>> filter_kruskal(csr_graph32 const& g, size_t threads)
+{
+	return filter_kruskal_csr(g, threads);
+}
+
+template <typename G>
+static std::vector<std::tuple<int, size_t, size_t>> boruvka_csr(G const& g, size_t threads)
+{
+	using id_t = typename G::id_t;
+	using edge = std::tuple<int, id_t, id_t>;
+	const auto none = std::numeric_limits<std::uint64_t>::max();
+	auto n = g.vertices();
+	auto t = parallel_threads(threads);
+	auto a = undirected_edges(g, t);
+	if (a.size() > std::numeric_limits<std::uint32_t>::max()) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	// 同一起点的边按终点排序后下标的顺序即为(起点, 终点)的顺序，(权, 下标)可打包为64位的键
+	parallel_for(a.size(), t, [&a](size_t, size_t lo, size_t hi) {
+		auto same = [&a](size_t i) { return std::get<1>(a[i - 1]) == std::get<1>(a[i]); };
+		while (lo != 0 && lo < a.size() && same(lo)) {
+			++lo;
+		}
+		while (hi != 0 && hi < a.size() && same(hi)) {
+			++hi;
+		}
+		for (auto b = lo; b < hi;) {
+			auto e = b + 1;
+			while (e != hi && std::get<1>(a[e]) == std::get<1>(a[b])) {
+				++e;
+			}
+			std::sort(a.begin() + static_cast<std::ptrdiff_t>(b), a.begin() + static_cast<std::ptrdiff_t>(e));
+			b = e;
+		}
+	});
+	auto key = [&a](size_t i) {
+		return static_cast<std::uint64_t>(static_cast<std::uint32_t>(std::get<0>(a[i])) ^ 0x80000000u) << 32 | i;
+	};
+	auto b = decltype(a)(a.size());
+	auto m = a.size();
+	auto f = concurrent_disjoint_set<id_t>(n);
+	auto comp = std::vector<id_t>(n);
+	std::iota(comp.begin(), comp.end(), id_t(0));
+	auto best = std::vector<std::atomic<std::uint64_t>>(n);
+	auto picked = std::vector<std::vector<std::tuple<int, size_t, size_t>>>(t);
+	while (m != 0) {
+		parallel_for(n, t, [&](size_t, size_t lo, size_t hi) {
+			for (auto v = lo; v != hi; ++v) {
+				best[v].store(none, std::memory_order_relaxed);
+			}
+		});
+		parallel_for(m, t, [&](size_t, size_t lo, size_t hi) {
+			for (auto i = lo; i != hi; ++i) {
+				auto k = key(i);
+				for (auto r : { comp[std::get<1>(a[i])], comp[std::get<2>(a[i])] }) {
+					auto cur = best[r].load(std::memory_order_relaxed);
+					while (k < cur && !best[r].compare_exchange_weak(cur, k, std::memory_order_relaxed)) { }
+				}
+			}
+		});
+		parallel_for(n, t, [&](size_t w, size_t lo, size_t hi) {
+			for (auto v = lo; v != hi; ++v) {
+				auto k = best[v].load(std::memory_order_relaxed);
+				if (k == none) {
+					continue;
+				}
+				auto const& e = a[k & 0xffffffffu];
+				if (f.unite(std::get<1>(e), std::get<2>(e))) {
+					picked[w].emplace_back(std::get<0>(e), std::get<1>(e), std::get<2>(e));
+				}
+			}
+		});
+		parallel_for(n, t, [&](size_t, size_t lo, size_t hi) {
+			for (auto v = lo; v != hi; ++v) {
+				comp[v] = f.find(static_cast<id_t>(v));
+			}
+		});
+		m = parallel_copy_if(a.begin(), a.begin() + static_cast<std::ptrdiff_t>(m), b.begin(), [&comp](edge const& e) {
+			return comp[std::get<1>(e)] != comp[std::get<2>(e)];
+		}, t);
+		a.swap(b);
+	}
+	auto ans = std::vector<std::tuple<int, size_t, size_t>>();
+	for (auto const& p : picked) {
+		ans.insert(ans.end(), p.begin(), p.end());
+	}
+	parallel_sort(ans.begin(), ans.end(), std::less<>(), t);
+	return ans;
+}
+
+std::vector<std::tuple<int, size_t, size_t>> boruvka(csr_graph const& g, size_t threads)
+{
+	return boruvka_csr(g, threads);
+}
+
+std::vector<std::tuple<int, size_t, size_t>> boruvka(csr_graph32 const& g, size_t threads)
+{
+	return boruvka_csr(g, threads);
+}
+
 #endif
\ No newline at end of file
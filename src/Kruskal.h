@@ -4,20 +4,86 @@
 
 #ifndef Kruskal_defined
 
+#include <algorithm>
 #include <array>
 #include <vector>
 #include "SparseMatrix.hpp"
+#include "CsrGraph.hpp"
 
 std::vector<std::tuple<int, size_t, size_t>> kruskal(std::vector<std::vector<std::pair<size_t, int>>> const& m);
 
+/**
+ * \brief CSR图上的kruskal
+ * \details 双向存储的边只取起点小于终点的一份参与排序
+ * \param g 无向图，每条边需双向存储
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> kruskal(csr_graph const& g);
+
+/**
+ * \brief 32位顶点编号CSR图上的kruskal
+ * \details 双向存储的边只取起点小于终点的一份参与排序
+ * \param g 无向图，每条边需双向存储
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> kruskal(csr_graph32 const& g);
+
+/**
+ * \brief CSR图上的filter-Kruskal
+ * \details
+ * 以抽样的中位数为枢轴将边划分为轻、重两半，先递归处理轻边，再并行滤去两端已连通的重边后递归处理剩余重边，
+ * 边数不超过顶点数时退化为排序后的kruskal。划分、过滤与排序均按块并行，
+ * 按(权, 起点, 终点)的全序处理边，结果与kruskal(g)完全相同
+ * \param g 无向图，每条边需双向存储
+ * \param threads 线程数，为0时使用硬件并发数
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> filter_kruskal(csr_graph const& g, size_t threads = 0);
+
+/**
+ * \brief 32位顶点编号CSR图上的filter-Kruskal
+ * \param g 无向图，每条边需双向存储
+ * \param threads 线程数，为0时使用硬件并发数
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> filter_kruskal(csr_graph32 const& g, size_t threads = 0);
+
+/**
+ * \brief CSR图上的并行Borůvka最小生成树
+ * \details
+ * 每轮并行地为每个连通分量以CAS取最小的出边(按(权, 起点, 终点)的全序比较)，
+ * 再以无锁并发并查集合并并去掉重复选中的边，最后滤去两端已连通的边，至多log2(n)轮。
+ * 全序保证最小生成树唯一，按权升序排列后的结果与kruskal(g)完全相同
+ * \param g 无向图，每条边需双向存储
+ * \param threads 线程数，为0时使用硬件并发数
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> boruvka(csr_graph const& g, size_t threads = 0);
+
+/**
+ * \brief 32位顶点编号CSR图上的并行Borůvka最小生成树
+ * \param g 无向图，每条边需双向存储
+ * \param threads 线程数，为0时使用硬件并发数
+ * \return 最小生成树(森林)的边(权, 起点, 终点)，按权升序
+ */
+std::vector<std::tuple<int, size_t, size_t>> boruvka(csr_graph32 const& g, size_t threads = 0);
+
+/**
+ * \brief 邻接矩阵上的kruskal
+ * \details 所有存储的元素都视为无向边，(i, j)与(j, i)可只存其一，也可都存
+ * \param map 邻接矩阵
+ * \return 最小生成树的边(权, 较小端点, 较大端点)，按权升序，图不连通时末尾为默认值
+ */
 template<size_t N>
 std::array<std::tuple<int, size_t, size_t>, N - 1> kruskal(sparse_matrix2d<int, N, N> const& map)
 {
-	auto m = std::vector<std::vector<std::pair<size_t, int>>>();
-	for(auto i = 0; i != N ;++i) {
-		m.emplace_back(map.row(i));
+	auto m = std::vector<std::vector<std::pair<size_t, int>>>(N);
+	for (auto const& e : map) {
+		auto i = std::get<0>(e.first);
+		auto j = std::get<1>(e.first);
+		m[std::min(i, j)].emplace_back(std::max(i, j), e.second);
 	}
-	auto x =  kruskal(m);
+	auto x = kruskal(m);
 	auto ret = std::array<std::tuple<int, size_t, size_t>, N - 1>();
 	std::copy(x.begin(), x.end(), ret.begin());
 	return ret;
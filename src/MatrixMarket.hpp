@@ -0,0 +1,426 @@
+#pragma once
+
+#ifndef MatrixMarket_disabled
+
+#ifndef MatrixMarket_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "SparseMatrix.hpp"
+#include "StrException.h"
+
+/// @brief Matrix Market(.mtx)坐标格式读写器
+/// @details
+/// 读取时按块缓冲输入流，使用手写的数值解析器，
+/// 由sparse_matrix2d::from_triplets批量排序后一次性顺序构建稀疏矩阵，避免逐个set()的开销
+struct matrix_market
+{
+	/// 元素数值类型
+	enum class field
+	{
+		Real,
+		Integer,
+		Pattern,
+	};
+
+	/// 矩阵对称性
+	enum class symmetry
+	{
+		General,
+		Symmetric,
+		SkewSymmetric,
+	};
+
+	/// @brief 从输入流读取矩阵
+	/// @details 重复坐标的值将被累加，累加后为0的元素将被丢弃
+	/// @return 读入的矩阵
+	/// @param in 输入流
+	/// @tparam T 矩阵元素类型
+	/// @tparam DimA 矩阵行数，需不小于文件中的行数
+	/// @tparam DimB 矩阵列数，需不小于文件中的列数
+	template <typename T, size_t DimA, size_t DimB>
+	static sparse_matrix2d<T, DimA, DimB> read(std::istream& in);
+
+	/// @brief 将矩阵以general坐标格式写入输出流
+	/// @param out 输出流
+	/// @param m 输出的矩阵
+	/// @tparam T 矩阵元素类型
+	/// @tparam DimA 矩阵行数
+	/// @tparam DimB 矩阵列数
+	template <typename T, size_t DimA, size_t DimB>
+	static void write(std::ostream& out, sparse_matrix2d<T, DimA, DimB> const& m);
+
+private:
+
+	/// @brief 分块缓冲的字符读取器
+	class chunk_reader
+	{
+		std::istream& in;
+		std::vector<char> buf;
+		size_t pos = 0;
+		size_t len = 0;
+
+		bool refill()
+		{
+			in.read(buf.data(), static_cast<std::streamsize>(buf.size()));
+			len = static_cast<size_t>(in.gcount());
+			pos = 0;
+			return len != 0;
+		}
+
+	public:
+		explicit chunk_reader(std::istream& in) : in(in), buf(1 << 20) {}
+
+		/// @brief 查看下一个字符
+		/// @return 下一个字符，流结束时返回EOF
+		int peek()
+		{
+			if (pos == len && !refill()) {
+				return EOF;
+			}
+			return static_cast<unsigned char>(buf[pos]);
+		}
+
+		/// @brief 读取下一个字符
+		/// @return 下一个字符，流结束时返回EOF
+		int get()
+		{
+			auto c = peek();
+			if (c != EOF) {
+				++pos;
+			}
+			return c;
+		}
+
+		/// 跳过行内空白
+		void skip_blank()
+		{
+			int c;
+			while ((c = peek()) == ' ' || c == '\t' || c == '\r') {
+				++pos;
+			}
+		}
+
+		/// 跳过空白与换行
+		void skip_space()
+		{
+			int c;
+			while ((c = peek()) == ' ' || c == '\t' || c == '\r' || c == '\n') {
+				++pos;
+			}
+		}
+
+		/// 跳过当前行剩余部分
+		void skip_line()
+		{
+			int c;
+			while ((c = get()) != EOF && c != '\n') {}
+		}
+
+		/// @brief 读取当前行剩余部分
+		/// @return 不含换行符的行内容
+		std::string line()
+		{
+			std::string ret;
+			int c;
+			while ((c = get()) != EOF && c != '\n') {
+				if (c != '\r') {
+					ret.push_back(static_cast<char>(c));
+				}
+			}
+			return ret;
+		}
+	};
+
+	/// @brief 解析无符号整数
+	/// @return 整数值
+	/// @param r 字符读取器
+	static size_t parse_index(chunk_reader& r)
+	{
+		r.skip_blank();
+		auto c = r.peek();
+		if (c < '0' || c > '9') {
+			throw str_exception(std::string(1, static_cast<char>(c)), L"此处需要整数");
+		}
+		size_t ret = 0;
+		while ((c = r.peek()) >= '0' && c <= '9') {
+			ret = ret * 10 + static_cast<size_t>(c - '0');
+			r.get();
+		}
+		return ret;
+	}
+
+	/// @brief 解析实数
+	/// @details 尾数不超过2^53且指数绝对值不超过22时结果精确，否则交由strtod处理
+	/// @return 实数值
+	/// @param r 字符读取器
+	static double parse_real(chunk_reader& r)
+	{
+		static const double pow10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+		char token[64];
+		size_t n = 0;
+		auto take = [&r, &token, &n]() {
+			auto c = r.get();
+			if (n != sizeof(token) - 1) {
+				token[n++] = static_cast<char>(c);
+			}
+			return c;
+		};
+
+		r.skip_blank();
+		auto negative = false;
+		if (r.peek() == '-' || r.peek() == '+') {
+			negative = take() == '-';
+		}
+		uint64_t mantissa = 0;
+		int digits = 0, exponent = 0;
+		auto any = false;
+		int c;
+		while ((c = r.peek()) >= '0' && c <= '9') {
+			take();
+			any = true;
+			if (digits < 19) {
+				mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+				digits += mantissa != 0;
+			} else {
+				++exponent;
+			}
+		}
+		if (r.peek() == '.') {
+			take();
+			while ((c = r.peek()) >= '0' && c <= '9') {
+				take();
+				any = true;
+				if (digits < 19) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+					digits += mantissa != 0;
+					--exponent;
+				}
+			}
+		}
+		if (!any) {
+			throw str_exception(std::string(token, n), L"此处需要数值");
+		}
+		if (r.peek() == 'e' || r.peek() == 'E') {
+			take();
+			auto exp_negative = false;
+			if (r.peek() == '-' || r.peek() == '+') {
+				exp_negative = take() == '-';
+			}
+			int e = 0;
+			while ((c = r.peek()) >= '0' && c <= '9') {
+				take();
+				if (e < 100000) {
+					e = e * 10 + (c - '0');
+				}
+			}
+			exponent += exp_negative ? -e : e;
+		}
+		if (mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+			auto v = static_cast<double>(mantissa);
+			v = exponent < 0 ? v / pow10[-exponent] : v * pow10[exponent];
+			return negative ? -v : v;
+		}
+		token[n] = '\0';
+		return std::strtod(token, nullptr);
+	}
+
+	/// @brief 解析一个实数并转换为元素类型
+	/// @return 元素值
+	/// @param r 字符读取器
+	/// @tparam T 矩阵元素类型，为无符号类型时负数抛出异常
+	template <typename T>
+	static T real_value(chunk_reader& r)
+	{
+		auto x = parse_real(r);
+		if (std::is_unsigned<T>::value && x < 0) {
+			throw str_exception("-", L"无符号类型不能为负数");
+		}
+		return static_cast<T>(x);
+	}
+
+	/// @brief 解析一个元素值
+	/// @return 元素值
+	/// @param r 字符读取器
+	/// @param f 元素数值类型
+	/// @tparam T 矩阵元素类型
+	template <typename T>
+	static T parse_value(chunk_reader& r, field f)
+	{
+		switch (f) {
+		case field::Pattern:
+			return T(1);
+		case field::Integer:
+			if (std::is_integral<T>::value) {
+				r.skip_blank();
+				auto negative = false;
+				if (r.peek() == '-' || r.peek() == '+') {
+					negative = r.get() == '-';
+				}
+				if (negative && std::is_unsigned<T>::value) {
+					throw str_exception("-", L"无符号类型不能为负数");
+				}
+				auto v = static_cast<T>(parse_index(r));
+				return negative ? static_cast<T>(-v) : v;
+			}
+			return real_value<T>(r);
+		default:
+			return real_value<T>(r);
+		}
+	}
+
+	/// @brief 将无符号整数写入缓冲区
+	/// @param buf 缓冲区
+	/// @param v 整数值
+	static void put_index(std::string& buf, size_t v)
+	{
+		char tmp[24];
+		auto p = tmp + sizeof(tmp);
+		do {
+			*--p = static_cast<char>('0' + v % 10);
+			v /= 10;
+		} while (v);
+		buf.append(p, tmp + sizeof(tmp));
+	}
+
+	/// @brief 将元素值写入缓冲区
+	/// @param buf 缓冲区
+	/// @param v 元素值
+	/// @tparam T 矩阵元素类型
+	template <typename T>
+	static void put_value(std::string& buf, T v)
+	{
+		if (std::is_integral<T>::value) {
+			if (v < T()) {
+				buf.push_back('-');
+				put_index(buf, static_cast<size_t>(0ull - static_cast<unsigned long long>(v)));
+			} else {
+				put_index(buf, static_cast<size_t>(v));
+			}
+		} else {
+			char tmp[32];
+			auto n = std::snprintf(tmp, sizeof(tmp), "%.17g", static_cast<double>(v));
+			buf.append(tmp, static_cast<size_t>(n));
+		}
+	}
+};
+
+template <typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> matrix_market::read(std::istream& in)
+{
+	auto r = chunk_reader(in);
+	auto banner = r.line();
+	std::transform(banner.begin(), banner.end(), banner.begin(), [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+	if (banner.compare(0, 14, "%%matrixmarket") != 0
+		|| banner.find(" matrix ") == std::string::npos
+		|| banner.find(" coordinate ") == std::string::npos) {
+		throw str_exception(banner, L"错误的矩阵头");
+	}
+
+	auto f = field::Real;
+	if (banner.find(" pattern") != std::string::npos) {
+		f = field::Pattern;
+	} else if (banner.find(" integer") != std::string::npos) {
+		f = field::Integer;
+	} else if (banner.find(" real") == std::string::npos && banner.find(" double") == std::string::npos) {
+		throw str_exception(banner, L"不支持的元素类型");
+	}
+
+	auto sym = symmetry::General;
+	if (banner.find(" skew-symmetric") != std::string::npos) {
+		sym = symmetry::SkewSymmetric;
+	} else if (banner.find(" symmetric") != std::string::npos) {
+		sym = symmetry::Symmetric;
+	} else if (banner.find(" general") == std::string::npos) {
+		throw str_exception(banner, L"不支持的对称类型");
+	}
+	if (sym == symmetry::SkewSymmetric && std::is_unsigned<T>::value) {
+		throw str_exception(banner, L"无符号类型不能为负数");
+	}
+
+	r.skip_space();
+	while (r.peek() == '%') {
+		r.skip_line();
+		r.skip_space();
+	}
+	auto rows = parse_index(r);
+	auto cols = parse_index(r);
+	auto nnz = parse_index(r);
+	r.skip_line();
+	if (rows > DimA || cols > DimB) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+
+	auto reserve = sym == symmetry::General ? nnz : 2 * nnz;
+	auto is = std::vector<size_t>();
+	auto js = std::vector<size_t>();
+	auto vs = std::vector<T>();
+	is.reserve(reserve);
+	js.reserve(reserve);
+	vs.reserve(reserve);
+	for (size_t k = 0; k != nnz; ++k) {
+		r.skip_space();
+		auto i = parse_index(r);
+		auto j = parse_index(r);
+		auto v = parse_value<T>(r, f);
+		r.skip_line();
+		if (i == 0 || j == 0 || i > rows || j > cols) {
+			throw std::out_of_range("Matrix bound check failed");
+		}
+		is.push_back(i - 1);
+		js.push_back(j - 1);
+		vs.push_back(v);
+		if (sym != symmetry::General && i != j) {
+			is.push_back(j - 1);
+			js.push_back(i - 1);
+			vs.push_back(sym == symmetry::Symmetric ? v : static_cast<T>(-v));
+		}
+	}
+	return sparse_matrix2d<T, DimA, DimB>::from_triplets(is, js, vs);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void matrix_market::write(std::ostream& out, sparse_matrix2d<T, DimA, DimB> const& m)
+{
+	auto buf = std::string("%%MatrixMarket matrix coordinate ");
+	buf += std::is_integral<T>::value ? "integer" : "real";
+	buf += " general\n";
+	put_index(buf, DimA);
+	buf.push_back(' ');
+	put_index(buf, DimB);
+	buf.push_back(' ');
+	put_index(buf, m.size());
+	buf.push_back('\n');
+	for (auto const& ele : m) {
+		put_index(buf, std::get<0>(ele.first) + 1);
+		buf.push_back(' ');
+		put_index(buf, std::get<1>(ele.first) + 1);
+		buf.push_back(' ');
+		put_value(buf, ele.second);
+		buf.push_back('\n');
+		if (buf.size() >= (1 << 20)) {
+			out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+			buf.clear();
+		}
+	}
+	out.write(buf.data(), static_cast<std::streamsize>(buf.size()));
+}
+
+#define MatrixMarket_defined
+
+#endif
+
+#endif
@@ -0,0 +1,218 @@
+#pragma once
+
+#ifndef Parallel_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// @brief 计算实际使用的线程数
+/// @return 线程数，至少为1
+/// @param threads 期望线程数，为0时使用硬件并发数
+inline size_t parallel_threads(size_t threads) noexcept
+{
+	if (threads == 0) {
+		threads = std::thread::hardware_concurrency();
+	}
+	return threads == 0 ? 1 : threads;
+}
+
+/// @brief 将[0, n)均分为连续的块并行执行
+/// @details 第0块在当前线程执行，块数不超过n
+/// @param n 任务总数
+/// @param threads 线程数，为0时使用硬件并发数
+/// @param f 以(块号, 起点, 终点)调用的函数
+/// @tparam F 函数类型
+template <typename F>
+void parallel_for(size_t n, size_t threads, F&& f)
+{
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n));
+	auto workers = std::vector<std::thread>();
+	workers.reserve(t - 1);
+	for (size_t i = 1; i < t; ++i) {
+		workers.emplace_back([&f, i, n, t] { f(i, n * i / t, n * (i + 1) / t); });
+	}
+	f(size_t(0), size_t(0), n / t);
+	for (auto& w : workers) {
+		w.join();
+	}
+}
+
+/// @brief 可重复使用的线程屏障
+/// @details 固定数目的线程每次都调用wait后才一起返回，之前的写入对之后的读取可见
+class parallel_barrier
+{
+	std::mutex lock;
+	std::condition_variable cv;
+
+	/// 参与的线程数
+	size_t threads;
+
+	/// 本轮已到达的线程数
+	size_t waiting = 0;
+
+	/// 已完成的轮数
+	size_t generation = 0;
+
+public:
+	/// @brief 构造屏障
+	/// @param threads 参与的线程数
+	explicit parallel_barrier(size_t threads) : threads(threads) {}
+
+	/// @brief 等待所有线程到达
+	void wait()
+	{
+		auto guard = std::unique_lock<std::mutex>(lock);
+		auto g = generation;
+		if (++waiting == threads) {
+			waiting = 0;
+			++generation;
+			cv.notify_all();
+		} else {
+			cv.wait(guard, [this, g] { return g != generation; });
+		}
+	}
+};
+
+/// @brief 在一组常驻线程上各执行一次f
+/// @details 第0个在当前线程执行，各线程在整个调用期间存活并可用屏障多轮同步，避免每轮创建与回收线程
+/// @param threads 线程数，为0时使用硬件并发数
+/// @param f 以(线程号, 屏障)调用的函数，每个线程须调用相同次数的wait
+/// @tparam F 函数类型
+template <typename F>
+void parallel_team(size_t threads, F&& f)
+{
+	auto t = parallel_threads(threads);
+	auto sync = parallel_barrier(t);
+	auto workers = std::vector<std::thread>();
+	workers.reserve(t - 1);
+	for (size_t i = 1; i < t; ++i) {
+		workers.emplace_back([&f, &sync, i] { f(i, sync); });
+	}
+	f(size_t(0), sync);
+	for (auto& w : workers) {
+		w.join();
+	}
+}
+
+/// @brief 并行排序
+/// @details 各块并行std::sort后逐轮两两归并，每轮的归并互不重叠并可并行
+/// @param first 起始迭代器
+/// @param last 结束迭代器
+/// @param comp 比较函数
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam It 随机访问迭代器类型
+/// @tparam C 比较函数类型
+template <typename It, typename C>
+void parallel_sort(It first, It last, C comp, size_t threads = 0)
+{
+	auto n = static_cast<size_t>(last - first);
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n / 4096));
+	if (t == 1) {
+		std::sort(first, last, comp);
+		return;
+	}
+	auto bound = [n, t](size_t i) { return static_cast<std::ptrdiff_t>(n * i / t); };
+	parallel_for(t, t, [&](size_t, size_t b, size_t e) {
+		for (auto i = b; i != e; ++i) {
+			std::sort(first + bound(i), first + bound(i + 1), comp);
+		}
+	});
+	for (size_t width = 1; width < t; width *= 2) {
+		auto pairs = (t + 2 * width - 1) / (2 * width);
+		parallel_for(pairs, t, [&](size_t, size_t b, size_t e) {
+			for (auto p = b; p != e; ++p) {
+				auto lo = 2 * width * p;
+				auto mid = std::min(lo + width, t);
+				auto hi = std::min(lo + 2 * width, t);
+				if (mid != hi) {
+					std::inplace_merge(first + bound(lo), first + bound(mid), first + bound(hi), comp);
+				}
+			}
+		});
+	}
+}
+
+/// @brief 并行稳定划分复制
+/// @details 按块统计满足条件的元素数、前缀和后分散写入，满足条件的元素依次写到out的前部，其余依次写到其后
+/// @return 满足条件的元素数
+/// @param first 起始迭代器
+/// @param last 结束迭代器
+/// @param out 输出起始迭代器，不能与输入重叠
+/// @param pred 条件
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam It 随机访问迭代器类型
+/// @tparam Out 随机访问输出迭代器类型
+/// @tparam P 条件类型
+template <typename It, typename Out, typename P>
+size_t parallel_partition_copy(It first, It last, Out out, P&& pred, size_t threads = 0)
+{
+	auto n = static_cast<size_t>(last - first);
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n / 4096));
+	auto count = std::vector<size_t>(t + 1, 0);
+	parallel_for(n, t, [&](size_t i, size_t b, size_t e) {
+		count[i + 1] = static_cast<size_t>(std::count_if(first + b, first + e, pred));
+	});
+	for (size_t i = 0; i != t; ++i) {
+		count[i + 1] += count[i];
+	}
+	auto total = count[t];
+	parallel_for(n, t, [&](size_t i, size_t b, size_t e) {
+		auto yes = count[i];
+		auto no = total + b - count[i];
+		for (auto k = b; k != e; ++k) {
+			if (pred(first[k])) {
+				out[yes++] = first[k];
+			} else {
+				out[no++] = first[k];
+			}
+		}
+	});
+	return total;
+}
+
+/// @brief 并行稳定复制满足条件的元素
+/// @return 复制的元素数
+/// @param first 起始迭代器
+/// @param last 结束迭代器
+/// @param out 输出起始迭代器，不能与输入重叠
+/// @param pred 条件
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam It 随机访问迭代器类型
+/// @tparam Out 随机访问输出迭代器类型
+/// @tparam P 条件类型
+template <typename It, typename Out, typename P>
+size_t parallel_copy_if(It first, It last, Out out, P&& pred, size_t threads = 0)
+{
+	auto n = static_cast<size_t>(last - first);
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n / 4096));
+	auto count = std::vector<size_t>(t + 1, 0);
+	auto flags = std::vector<unsigned char>(n);
+	parallel_for(n, t, [&](size_t i, size_t b, size_t e) {
+		size_t c = 0;
+		for (auto k = b; k != e; ++k) {
+			flags[k] = pred(first[k]) ? 1 : 0;
+			c += flags[k];
+		}
+		count[i + 1] = c;
+	});
+	for (size_t i = 0; i != t; ++i) {
+		count[i + 1] += count[i];
+	}
+	parallel_for(n, t, [&](size_t i, size_t b, size_t e) {
+		auto pos = count[i];
+		for (auto k = b; k != e; ++k) {
+			if (flags[k]) {
+				out[pos++] = first[k];
+			}
+		}
+	});
+	return count[t];
+}
+
+#define Parallel_defined
+
+#endif
@@ -0,0 +1,345 @@
+#pragma once
+
+#ifndef PriorityQueue_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/// @brief 供dijkstra等图算法使用的最小优先队列策略
+/// @details
+/// 每种策略以顶点数构造，提供empty、push(v, key)与pop，pop返回(key, v)。
+/// push用于插入或降低顶点的键，不支持降键的策略会保留旧条目，调用方需跳过键与当前距离不符的条目
+
+/// @brief 惰性二叉堆，每次push插入新条目，堆大小可达O(E)
+class lazy_binary_heap
+{
+	/// 底层堆
+	std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t>>, std::greater<>> q;
+
+public:
+	/// @brief 构造空队列
+	/// @param n 顶点数，未使用
+	explicit lazy_binary_heap(size_t n) { (void)n; }
+
+	/// @brief 是否为空
+	/// @return 为空时返回真
+	bool empty() const noexcept { return q.empty(); }
+
+	/// @brief 插入条目
+	/// @param v 顶点
+	/// @param key 键
+	void push(size_t v, int key) { q.emplace(key, v); }
+
+	/// @brief 弹出最小条目
+	/// @return (键, 顶点)
+	std::pair<int, size_t> pop()
+	{
+		auto ret = q.top();
+		q.pop();
+		return ret;
+	}
+};
+
+/// @brief 单调基数堆，要求键非负且弹出的键单调不减
+/// @details 条目按与上次弹出键的最高不同位分桶，每个条目至多被重新分桶32次，dijkstra的非负整数边权满足单调性
+class radix_heap
+{
+	/// 按最高不同位分的桶，桶0中的键均等于last
+	std::array<std::vector<std::pair<std::uint32_t, size_t>>, 33> buckets;
+
+	/// 上次弹出的键
+	std::uint32_t last = 0;
+
+	/// 条目个数
+	size_t count = 0;
+
+	/// @brief 键所在的桶
+	/// @return 桶号
+	/// @param key 键
+	size_t bucket(std::uint32_t key) const noexcept
+	{
+		auto x = key ^ last;
+#if defined(__GNUC__) || defined(__clang__)
+		return x == 0 ? 0 : 32 - static_cast<size_t>(__builtin_clz(x));
+#else
+		size_t b = 0;
+		for (; x != 0; x >>= 1) {
+			++b;
+		}
+		return b;
+#endif
+	}
+
+public:
+	/// @brief 构造空队列
+	/// @param n 顶点数，未使用
+	explicit radix_heap(size_t n) { (void)n; }
+
+	/// @brief 是否为空
+	/// @return 为空时返回真
+	bool empty() const noexcept { return count == 0; }
+
+	/// @brief 插入条目，键不能小于上次弹出的键
+	/// @param v 顶点
+	/// @param key 键
+	void push(size_t v, int key)
+	{
+		auto k = static_cast<std::uint32_t>(key);
+		buckets[bucket(k)].emplace_back(k, v);
+		++count;
+	}
+
+	/// @brief 弹出最小条目
+	/// @return (键, 顶点)
+	std::pair<int, size_t> pop()
+	{
+		if (buckets[0].empty()) {
+			size_t i = 1;
+			while (buckets[i].empty()) {
+				++i;
+			}
+			last = std::min_element(buckets[i].begin(), buckets[i].end())->first;
+			for (auto const& e : buckets[i]) {
+				buckets[bucket(e.first)].push_back(e);
+			}
+			buckets[i].clear();
+		}
+		auto ret = buckets[0].back();
+		buckets[0].pop_back();
+		--count;
+		return std::make_pair(static_cast<int>(ret.first), ret.second);
+	}
+};
+
+/// @brief 带索引的D叉堆，push对已在堆中的顶点执行降键，堆中每个顶点至多一个条目
+/// @tparam D 叉数
+template <size_t D = 4>
+class indexed_dary_heap
+{
+	/// 不在堆中的位置标记
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	/// 堆中的顶点
+	std::vector<size_t> heap;
+
+	/// 顶点在堆中的位置
+	std::vector<size_t> pos;
+
+	/// 顶点的键
+	std::vector<int> key;
+
+	/// @brief 将顶点放到位置j
+	/// @param v 顶点
+	/// @param j 位置
+	void place(size_t v, size_t j) noexcept
+	{
+		heap[j] = v;
+		pos[v] = j;
+	}
+
+	/// @brief 上浮
+	/// @param i 位置
+	void sift_up(size_t i) noexcept
+	{
+		auto v = heap[i];
+		while (i != 0) {
+			auto p = (i - 1) / D;
+			if (key[heap[p]] <= key[v]) {
+				break;
+			}
+			place(heap[p], i);
+			i = p;
+		}
+		place(v, i);
+	}
+
+	/// @brief 下沉
+	/// @param i 位置
+	void sift_down(size_t i) noexcept
+	{
+		auto v = heap[i];
+		auto n = heap.size();
+		for (;;) {
+			auto c = i * D + 1;
+			if (c >= n) {
+				break;
+			}
+			auto best = c;
+			for (auto k = c + 1; k < std::min(c + D, n); ++k) {
+				if (key[heap[k]] < key[heap[best]]) {
+					best = k;
+				}
+			}
+			if (key[heap[best]] >= key[v]) {
+				break;
+			}
+			place(heap[best], i);
+			i = best;
+		}
+		place(v, i);
+	}
+
+public:
+	/// @brief 构造空队列
+	/// @param n 顶点数，顶点编号需小于n
+	explicit indexed_dary_heap(size_t n) : pos(n, npos), key(n) { }
+
+	/// @brief 是否为空
+	/// @return 为空时返回真
+	bool empty() const noexcept { return heap.empty(); }
+
+	/// @brief 插入顶点或降低其键，键不小于当前键时不做任何事
+	/// @param v 顶点
+	/// @param k 键
+	void push(size_t v, int k)
+	{
+		if (pos[v] == npos) {
+			key[v] = k;
+			heap.push_back(v);
+			sift_up(heap.size() - 1);
+		} else if (k < key[v]) {
+			key[v] = k;
+			sift_up(pos[v]);
+		}
+	}
+
+	/// @brief 弹出最小条目
+	/// @return (键, 顶点)
+	std::pair<int, size_t> pop()
+	{
+		auto v = heap.front();
+		pos[v] = npos;
+		if (heap.size() > 1) {
+			heap.front() = heap.back();
+			heap.pop_back();
+			sift_down(0);
+		} else {
+			heap.pop_back();
+		}
+		return std::make_pair(key[v], v);
+	}
+};
+
+/// @brief 带索引的配对堆，push对已在堆中的顶点执行降键，堆中每个顶点至多一个条目
+/// @details
+/// 节点即顶点编号，以最左子节点、右兄弟与左侧链接(最左子节点指向父节点)三个数组表示多叉树。
+/// 插入与降键为O(1)的合并，降键时把子树从兄弟链中剪下再与根合并；弹出时对子节点做两趟配对合并，均摊O(log n)
+class pairing_heap
+{
+	/// 空链接
+	static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+	/// 顶点的键
+	std::vector<int> key;
+
+	/// 最左子节点
+	std::vector<size_t> child;
+
+	/// 右兄弟
+	std::vector<size_t> next;
+
+	/// 左兄弟，最左子节点为父节点
+	std::vector<size_t> prev;
+
+	/// 顶点是否在堆中
+	std::vector<unsigned char> in;
+
+	/// 弹出时第一趟配对的结果
+	std::vector<size_t> pairs;
+
+	/// 根
+	size_t root = npos;
+
+	/// @brief 合并两棵树，键大的根成为另一根的最左子节点
+	/// @return 新根
+	/// @param a 根，不能有兄弟
+	/// @param b 根，不能有兄弟
+	size_t meld(size_t a, size_t b) noexcept
+	{
+		if (key[b] < key[a]) {
+			std::swap(a, b);
+		}
+		next[b] = child[a];
+		if (child[a] != npos) {
+			prev[child[a]] = b;
+		}
+		prev[b] = a;
+		child[a] = b;
+		return a;
+	}
+
+public:
+	/// @brief 构造空队列
+	/// @param n 顶点数，顶点编号需小于n
+	explicit pairing_heap(size_t n) : key(n), child(n, npos), next(n, npos), prev(n, npos), in(n, 0) { }
+
+	/// @brief 是否为空
+	/// @return 为空时返回真
+	bool empty() const noexcept { return root == npos; }
+
+	/// @brief 插入顶点或降低其键，键不小于当前键时不做任何事
+	/// @param v 顶点
+	/// @param k 键
+	void push(size_t v, int k)
+	{
+		if (!in[v]) {
+			in[v] = 1;
+			key[v] = k;
+			child[v] = next[v] = prev[v] = npos;
+			root = root == npos ? v : meld(root, v);
+		} else if (k < key[v]) {
+			key[v] = k;
+			if (v == root) {
+				return;
+			}
+			auto p = prev[v];
+			if (child[p] == v) {
+				child[p] = next[v];
+			} else {
+				next[p] = next[v];
+			}
+			if (next[v] != npos) {
+				prev[next[v]] = p;
+			}
+			next[v] = prev[v] = npos;
+			root = meld(root, v);
+		}
+	}
+
+	/// @brief 弹出最小条目
+	/// @return (键, 顶点)
+	std::pair<int, size_t> pop()
+	{
+		auto v = root;
+		in[v] = 0;
+		pairs.clear();
+		for (auto c = child[v]; c != npos;) {
+			auto a = c;
+			auto b = next[a];
+			next[a] = prev[a] = npos;
+			if (b == npos) {
+				pairs.push_back(a);
+				break;
+			}
+			c = next[b];
+			next[b] = prev[b] = npos;
+			pairs.push_back(meld(a, b));
+		}
+		child[v] = npos;
+		root = npos;
+		for (auto it = pairs.rbegin(); it != pairs.rend(); ++it) {
+			root = root == npos ? *it : meld(root, *it);
+		}
+		return std::make_pair(key[v], v);
+	}
+};
+
+#define PriorityQueue_defined
+
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+#ifndef Semiring_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <limits>
+
+/// @brief 编译期半环，供稀疏矩阵乘法与矩阵向量乘使用
+/// @details
+/// 半环提供加法单位元zero、乘法单位元one以及加法add与乘法mul，
+/// 稀疏矩阵中未存储的元素视为zero，乘积中等于zero的元素不会被存储，读取结果时用get<S>使未存储的元素返回zero
+
+/// @brief 普通加乘半环 (+, *)，用于数值乘积
+/// @tparam T 元素类型
+template <typename T>
+struct plus_times
+{
+	static constexpr T zero() noexcept { return T(); }
+	static constexpr T one() noexcept { return T(1); }
+	static constexpr T add(T a, T b) noexcept { return a + b; }
+	static constexpr T mul(T a, T b) noexcept { return a * b; }
+};
+
+/// @brief 热带半环 (min, +)，用于最短路
+/// @details zero为无穷大(整数取最大值)，整数加法正向溢出时饱和为zero，负边权下反向溢出时饱和为最小值
+/// @tparam T 元素类型
+template <typename T>
+struct min_plus
+{
+	static constexpr T zero() noexcept
+	{
+		return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+	}
+	static constexpr T one() noexcept { return T(); }
+	static constexpr T add(T a, T b) noexcept { return std::min(a, b); }
+	static constexpr T mul(T a, T b) noexcept
+	{
+		if (a == zero() || b == zero()) {
+			return zero();
+		}
+		if (a > T() && b > zero() - a) {
+			return zero();
+		}
+		if (a < T() && b < std::numeric_limits<T>::lowest() - a) {
+			return std::numeric_limits<T>::lowest();
+		}
+		return a + b;
+	}
+};
+
+/// @brief 布尔半环 (or, and)，用于可达性与传递闭包
+/// @details 非零即为真，结果为T(1)或T()
+/// @tparam T 元素类型
+template <typename T>
+struct or_and
+{
+	static constexpr T zero() noexcept { return T(); }
+	static constexpr T one() noexcept { return T(1); }
+	static constexpr T add(T a, T b) noexcept { return a != T() || b != T() ? T(1) : T(); }
+	static constexpr T mul(T a, T b) noexcept { return a != T() && b != T() ? T(1) : T(); }
+};
+
+/// @brief 瓶颈半环 (max, min)，用于最大瓶颈路径
+/// @tparam T 元素类型
+template <typename T>
+struct max_min
+{
+	static constexpr T zero() noexcept
+	{
+		return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+	}
+	static constexpr T one() noexcept
+	{
+		return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+	}
+	static constexpr T add(T a, T b) noexcept { return std::max(a, b); }
+	static constexpr T mul(T a, T b) noexcept { return std::min(a, b); }
+};
+
+#define Semiring_defined
+
+#endif
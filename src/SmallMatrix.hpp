@@ -0,0 +1,465 @@
+#pragma once
+
+#ifndef SmallMatrix_disabled
+
+#ifndef SmallMatrix_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Semiring.hpp"
+#include "SparseMatrix.hpp"
+
+/// small_matrix2d的元素个数上限，占用位图恰为一个64位字
+constexpr size_t small_matrix2d_limit = 64;
+
+/// @brief 小尺寸定长二维稀疏矩阵
+/// @details
+/// 以内联的稠密数组加占用位图存储，不使用堆内存，
+/// 全部运算的循环边界均为编译期常量，可在常量表达式中求值，接口与sparse_matrix2d一致
+/// @tparam T 矩阵元素类型，需为字面类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+class small_matrix2d
+{
+	static_assert(DimA * DimB <= small_matrix2d_limit, "Matrix too large for small_matrix2d");
+
+public:
+	//声明所有模版特化为友元类
+	template<typename, size_t, size_t> friend class small_matrix2d;
+
+	/// 默认构造函数
+	constexpr small_matrix2d() noexcept;
+
+	/// @brief 以二维数组为参数的构造函数
+	/// @param Args 输入的二维矩阵
+	/// @tparam A 矩阵行数
+	/// @tparam B 矩阵列数
+	template<size_t A, size_t B>
+	constexpr explicit small_matrix2d(const T (&Args)[A][B]);
+
+	/// @brief 由二维稀疏矩阵构造
+	/// @param m 源矩阵
+	explicit small_matrix2d(sparse_matrix2d<T, DimA, DimB> const& m);
+
+private:
+
+	/// 行主序的元素值
+	T val[DimA * DimB == 0 ? 1 : DimA * DimB] {};
+
+	/// 占用位图，第r * DimB + c位表示(r, c)处存有元素
+	uint64_t mask = 0;
+
+	/// @brief 坐标对应的位
+	/// @return 位
+	/// @param r 行坐标
+	/// @param c 列坐标
+	static constexpr uint64_t bit(size_t r, size_t c) noexcept;
+
+	/// @brief 动态边界检查
+	/// @param r 行坐标
+	/// @param c 列坐标
+	static constexpr void dim_bound_check(size_t r, size_t c);
+
+	/// @brief 逐元素合并两个矩阵，结果为0的元素不会被存储
+	/// @return 合并结果
+	/// @param m2 目标矩阵
+	/// @param f 合并函数，缺失的一方以T()代入
+	/// @tparam F 合并函数类型
+	template <typename F>
+	constexpr small_matrix2d<T, DimA, DimB> merge(small_matrix2d<T, DimA, DimB> const& m2, F f) const noexcept;
+
+public:
+
+	/// @brief 动态边界检查的设置
+	/// @param ele 值
+	/// @param DimAs 行坐标
+	/// @param DimBs 列坐标
+	constexpr void set(T ele, size_t DimAs, size_t DimBs);
+
+	/// @brief 静态边界检查的设置
+	/// @param ele 值
+	/// @tparam DimAs 行坐标
+	/// @tparam DimBs 列坐标
+	template<size_t DimAs, size_t DimBs>
+	constexpr void set(T ele) noexcept;
+
+	/// @brief 动态边界检查的获取
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	constexpr T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 静态边界检查的获取
+	/// @return 值
+	/// @tparam DimAg 行坐标
+	/// @tparam DimBg 列坐标
+	template<size_t DimAg, size_t DimBg>
+	constexpr T get() const noexcept;
+
+	/// @brief 动态边界检查的查找
+	/// @return 是否存在
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	/// @param out 返回值
+	constexpr bool have(size_t DimAg, size_t DimBg, T& out) const;
+
+	/// @brief 静态边界检查的查找
+	/// @return 是否存在
+	/// @tparam DimAg 行坐标
+	/// @tparam DimBg 列坐标
+	/// @param out 返回值
+	template<size_t DimAg, size_t DimBg>
+	constexpr bool have(T& out) const noexcept;
+
+	/// @brief 动态边界检查获取指定行
+	/// @return 指定行
+	/// @param r 行号
+	std::vector<std::pair<size_t, T>> row(size_t r) const;
+
+	/// @brief 静态边界检查获取指定行
+	/// @return 指定行
+	/// @tparam R 行号
+	template<size_t R>
+	std::vector<std::pair<size_t, T>> row() const;
+
+	/// @brief 动态边界检查获取指定行的非零元素个数
+	/// @return 元素个数
+	/// @param r 行号
+	constexpr size_t row_size(size_t r) const;
+
+	/// @brief 非零元素个数
+	/// @return 存储的元素个数
+	constexpr size_t size() const noexcept;
+
+	/// @brief AxB与BxC的矩阵乘积
+	/// @details 结果为半环zero的元素不会被存储
+	/// @return 乘积
+	/// @param m2 目标矩阵
+	/// @tparam S 半环，默认为普通加乘
+	/// @tparam DimC 矩阵2的列数
+	template <typename S = plus_times<T>, size_t DimC>
+	constexpr small_matrix2d<T, DimA, DimC> Mul(small_matrix2d<T, DimB, DimC> const& m2) const noexcept;
+
+	/// @brief AxB的矩阵加法
+	/// @return 和
+	/// @param m2 目标矩阵
+	constexpr small_matrix2d<T, DimA, DimB> Add(small_matrix2d<T, DimA, DimB> const& m2) const noexcept;
+
+	/// @brief AxB的矩阵减法
+	/// @return 差
+	/// @param m2 目标矩阵
+	constexpr small_matrix2d<T, DimA, DimB> Sub(small_matrix2d<T, DimA, DimB> const& m2) const noexcept;
+
+	/// @brief AxB的矩阵线性组合 a*this + b*m2
+	/// @return 线性组合
+	/// @param a 本矩阵的系数
+	/// @param m2 目标矩阵
+	/// @param b 目标矩阵的系数
+	constexpr small_matrix2d<T, DimA, DimB> Axpby(T a, small_matrix2d<T, DimA, DimB> const& m2, T b) const noexcept;
+
+	/// @brief AxB的矩阵转置
+	/// @return 转置
+	constexpr small_matrix2d<T, DimB, DimA> Rev() const noexcept;
+
+	/// @brief 转换为二维稀疏矩阵
+	/// @return 二维稀疏矩阵
+	sparse_matrix2d<T, DimA, DimB> to_sparse() const;
+};
+
+/// @brief 按尺寸自动选择的二维稀疏矩阵类型
+/// @details 元素个数不超过small_matrix2d_limit时为small_matrix2d，否则为sparse_matrix2d
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename T, size_t DimA, size_t DimB>
+using matrix2d_t = typename std::conditional<DimA * DimB <= small_matrix2d_limit, small_matrix2d<T, DimA, DimB>, sparse_matrix2d<T, DimA, DimB>>::type;
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB>::small_matrix2d() noexcept {}
+
+template <typename T, size_t DimA, size_t DimB>
+template<size_t A, size_t B>
+constexpr small_matrix2d<T, DimA, DimB>::small_matrix2d(const T (&Args)[A][B])
+{
+	static_assert(A == DimA, "Row size doesn't match");
+	static_assert(B == DimB, "Col size doesn't match");
+	for (size_t i = 0; i != DimA; ++i) {
+		for (size_t j = 0; j != DimB; ++j) {
+			if (Args[i][j] != T()) {
+				val[i * DimB + j] = Args[i][j];
+				mask |= bit(i, j);
+			}
+		}
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+small_matrix2d<T, DimA, DimB>::small_matrix2d(sparse_matrix2d<T, DimA, DimB> const& m)
+{
+	for (auto const& ele : m) {
+		set(ele.second, std::get<0>(ele.first), std::get<1>(ele.first));
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr uint64_t small_matrix2d<T, DimA, DimB>::bit(size_t r, size_t c) noexcept
+{
+	return uint64_t(1) << (r * DimB + c);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr void small_matrix2d<T, DimA, DimB>::dim_bound_check(size_t r, size_t c)
+{
+	if (DimA <= r || DimB <= c) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename F>
+constexpr small_matrix2d<T, DimA, DimB> small_matrix2d<T, DimA, DimB>::merge(small_matrix2d<T, DimA, DimB> const& m2, F f) const noexcept
+{
+	small_matrix2d<T, DimA, DimB> res;
+	for (size_t k = 0; k != DimA * DimB; ++k) {
+		auto b = uint64_t(1) << k;
+		if ((mask | m2.mask) & b) {
+			auto v = f(mask & b ? val[k] : T(), m2.mask & b ? m2.val[k] : T());
+			if (v != T()) {
+				res.val[k] = v;
+				res.mask |= b;
+			}
+		}
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr void small_matrix2d<T, DimA, DimB>::set(T ele, size_t DimAs, size_t DimBs)
+{
+	dim_bound_check(DimAs, DimBs);
+	val[DimAs * DimB + DimBs] = ele;
+	mask |= bit(DimAs, DimBs);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template<size_t DimAs, size_t DimBs>
+constexpr void small_matrix2d<T, DimA, DimB>::set(T ele) noexcept
+{
+	static_assert(dim_bound_check_static<DimA, DimB>(DimAs, DimBs), "Matrix bound check failed");
+	val[DimAs * DimB + DimBs] = ele;
+	mask |= bit(DimAs, DimBs);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr T small_matrix2d<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	dim_bound_check(DimAg, DimBg);
+	return mask & bit(DimAg, DimBg) ? val[DimAg * DimB + DimBg] : T();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template<size_t DimAg, size_t DimBg>
+constexpr T small_matrix2d<T, DimA, DimB>::get() const noexcept
+{
+	static_assert(dim_bound_check_static<DimA, DimB>(DimAg, DimBg), "Matrix bound check failed");
+	return mask & bit(DimAg, DimBg) ? val[DimAg * DimB + DimBg] : T();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr bool small_matrix2d<T, DimA, DimB>::have(size_t DimAg, size_t DimBg, T& out) const
+{
+	dim_bound_check(DimAg, DimBg);
+	auto found = (mask & bit(DimAg, DimBg)) != 0;
+	out = found ? val[DimAg * DimB + DimBg] : T();
+	return found;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template<size_t DimAg, size_t DimBg>
+constexpr bool small_matrix2d<T, DimA, DimB>::have(T& out) const noexcept
+{
+	static_assert(dim_bound_check_static<DimA, DimB>(DimAg, DimBg), "Matrix bound check failed");
+	auto found = (mask & bit(DimAg, DimBg)) != 0;
+	out = found ? val[DimAg * DimB + DimBg] : T();
+	return found;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::vector<std::pair<size_t, T>> small_matrix2d<T, DimA, DimB>::row(size_t r) const
+{
+	if (DimA <= r) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	auto ret = std::vector<std::pair<size_t, T>>();
+	for (size_t j = 0; j != DimB; ++j) {
+		if (mask & bit(r, j)) {
+			ret.emplace_back(j, val[r * DimB + j]);
+		}
+	}
+	return ret;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template<size_t R>
+std::vector<std::pair<size_t, T>> small_matrix2d<T, DimA, DimB>::row() const
+{
+	static_assert(R < DimA, "Matrix bound check failed");
+	return row(R);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr size_t small_matrix2d<T, DimA, DimB>::row_size(size_t r) const
+{
+	if (DimA <= r) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	size_t n = 0;
+	for (size_t j = 0; j != DimB; ++j) {
+		n += (mask & bit(r, j)) != 0;
+	}
+	return n;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr size_t small_matrix2d<T, DimA, DimB>::size() const noexcept
+{
+	size_t n = 0;
+	for (auto m = mask; m != 0; m &= m - 1) {
+		++n;
+	}
+	return n;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S, size_t DimC>
+constexpr small_matrix2d<T, DimA, DimC> small_matrix2d<T, DimA, DimB>::Mul(small_matrix2d<T, DimB, DimC> const& m2) const noexcept
+{
+	small_matrix2d<T, DimA, DimC> res;
+	for (size_t i = 0; i != DimA; ++i) {
+		for (size_t j = 0; j != DimC; ++j) {
+			auto touched = false;
+			T a = S::zero();
+			for (size_t k = 0; k != DimB; ++k) {
+				if ((mask & bit(i, k)) && (m2.mask & m2.bit(k, j))) {
+					auto p = S::mul(val[i * DimB + k], m2.val[k * DimC + j]);
+					a = touched ? S::add(a, p) : p;
+					touched = true;
+				}
+			}
+			if (touched && a != S::zero()) {
+				res.val[i * DimC + j] = a;
+				res.mask |= res.bit(i, j);
+			}
+		}
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> small_matrix2d<T, DimA, DimB>::Add(small_matrix2d<T, DimA, DimB> const& m2) const noexcept
+{
+	return merge(m2, [](T x, T y) { return x + y; });
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> small_matrix2d<T, DimA, DimB>::Sub(small_matrix2d<T, DimA, DimB> const& m2) const noexcept
+{
+	return merge(m2, [](T x, T y) { return x - y; });
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> small_matrix2d<T, DimA, DimB>::Axpby(T a, small_matrix2d<T, DimA, DimB> const& m2, T b) const noexcept
+{
+	return merge(m2, [a, b](T x, T y) { return a * x + b * y; });
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimB, DimA> small_matrix2d<T, DimA, DimB>::Rev() const noexcept
+{
+	small_matrix2d<T, DimB, DimA> res;
+	for (size_t i = 0; i != DimA; ++i) {
+		for (size_t j = 0; j != DimB; ++j) {
+			if (mask & bit(i, j)) {
+				res.val[j * DimA + i] = val[i * DimB + j];
+				res.mask |= res.bit(j, i);
+			}
+		}
+	}
+	return res;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> small_matrix2d<T, DimA, DimB>::to_sparse() const
+{
+	sparse_matrix2d<T, DimA, DimB> res;
+	for (size_t i = 0; i != DimA; ++i) {
+		for (size_t j = 0; j != DimB; ++j) {
+			if (mask & bit(i, j)) {
+				res.set(val[i * DimB + j], i, j);
+			}
+		}
+	}
+	return res;
+}
+
+/// @brief 矩阵加法
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> operator+(small_matrix2d<T, DimA, DimB> const& a, small_matrix2d<T, DimA, DimB> const& b) noexcept
+{
+	return a.Add(b);
+}
+
+/// @brief 矩阵减法
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> operator-(small_matrix2d<T, DimA, DimB> const& a, small_matrix2d<T, DimA, DimB> const& b) noexcept
+{
+	return a.Sub(b);
+}
+
+/// @brief 矩阵数乘
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> operator*(T c, small_matrix2d<T, DimA, DimB> const& a) noexcept
+{
+	return a.Axpby(c, a, T());
+}
+
+/// @brief 矩阵数乘
+template <typename T, size_t DimA, size_t DimB>
+constexpr small_matrix2d<T, DimA, DimB> operator*(small_matrix2d<T, DimA, DimB> const& a, T c) noexcept
+{
+	return a.Axpby(c, a, T());
+}
+
+/// @brief 矩阵乘法
+template <typename T, size_t DimA, size_t DimB, size_t DimC>
+constexpr small_matrix2d<T, DimA, DimC> operator*(small_matrix2d<T, DimA, DimB> const& a, small_matrix2d<T, DimB, DimC> const& b) noexcept
+{
+	return a.Mul(b);
+}
+
+/// @brief AxB的矩阵输出
+/// @return 原输出流
+/// @param out 输出流
+/// @param d 输出的矩阵
+template <typename T, size_t DimA, size_t DimB>
+std::ostream& operator<< (std::ostream& out, small_matrix2d<T, DimA, DimB> const& d) noexcept
+{
+	for (size_t i = 0; i != DimA; ++i) {
+		for (size_t j = 0; j != DimB; ++j) {
+			out << (j ? " " : "") << d.get(i, j);
+		}
+		out << std::endl;
+	}
+	return out;
+}
+
+#define SmallMatrix_defined
+
+#endif
+
+#endif
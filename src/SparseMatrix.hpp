@@ -4,11 +4,22 @@
 
 #ifndef sparse_matrix_defined
 // ReSharper disable CppUnusedIncludeDirective
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <map>
+#include <mutex>
+#include <stdexcept>
+#include <numeric>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
+#include "Parallel.hpp"
+#include "Semiring.hpp"
 
 #ifdef Use_FoldExp
 template <size_t ...Dims>
@@ -22,12 +33,63 @@ constexpr bool dim_bound_check_static(size_t arga, size_t argb) {
 }
 #endif
 
+/// @brief 转置排列：求行主序元素按(列, 行)排序后的下标序列
+/// @details
+/// 列数不超过元素数的常数倍时使用计数排序(按块统计列直方图、前缀和、分散写入)，
+/// 各块按行连续划分并可并行处理；否则退化为按列的稳定排序
+/// @return 转置后第i个元素在原序列中的下标
+/// @param cols 按行主序排列的各元素列号
+/// @param dim 列数
+/// @param threads 线程数，为0时使用硬件并发数
+inline std::vector<size_t> transpose_order(std::vector<size_t> const& cols, size_t dim, size_t threads = 1)
+{
+	auto n = cols.size();
+	auto order = std::vector<size_t>(n);
+	if (dim > 4 * n + 1024) {
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&cols](size_t a, size_t b) { return cols[a] < cols[b]; });
+		return order;
+	}
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), n));
+	auto hist = std::vector<std::vector<size_t>>(t);
+	parallel_for(n, t, [&cols, &hist, dim](size_t i, size_t b, size_t e) {
+		hist[i].assign(dim, 0);
+		for (auto k = b; k != e; ++k) {
+			++hist[i][cols[k]];
+		}
+	});
+	size_t sum = 0;
+	for (size_t c = 0; c != dim; ++c) {
+		for (auto& h : hist) {
+			auto cnt = h[c];
+			h[c] = sum;
+			sum += cnt;
+		}
+	}
+	parallel_for(n, t, [&cols, &hist, &order](size_t i, size_t b, size_t e) {
+		auto& h = hist[i];
+		for (auto k = b; k != e; ++k) {
+			order[h[cols[k]]++] = k;
+		}
+	});
+	return order;
+}
+
 template <typename T, size_t DimA, size_t DimB>
 class sparse_matrix2d;
 
 template <typename T, size_t DimA, size_t DimB>
 std::ostream& operator<< (std::ostream& out, const sparse_matrix2d<T, DimA, DimB>& d) noexcept;
 
+template <typename T, size_t DimA, size_t DimB>
+class csr_matrix;
+
+template <typename T, size_t DimA, size_t DimB, size_t BS>
+class bsr_matrix;
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+class sparse_matrix2d_expr;
+
 /// @brief 二维稀疏矩阵
 /// @details
 /// 二维稀疏矩阵，实现了矩阵的基本操作
@@ -48,9 +110,22 @@ public:
 	template<size_t A, size_t B>
 	constexpr explicit sparse_matrix2d(const T (&Args)[A][B]);
 
+	/// @brief 由惰性表达式求值构造
+	/// @param e 表达式
+	/// @tparam E 表达式类型
+	template<typename E>
+	sparse_matrix2d(sparse_matrix2d_expr<E, T, DimA, DimB> const& e);
+
 	//声明所有模版特化为友元类
 	template<typename, size_t, size_t> friend class sparse_matrix2d;
 
+	//声明压缩存储矩阵为友元类
+	template<typename, size_t, size_t> friend class csr_matrix;
+	template<typename, size_t, size_t, size_t> friend class bsr_matrix;
+
+	//声明惰性表达式为友元类
+	template<typename, typename, size_t, size_t> friend class sparse_matrix2d_expr;
+
 	/// 矩阵坐标类型
 	using dim_t = std::tuple<size_t, size_t>;
 
@@ -60,6 +135,9 @@ public:
 	/// 矩阵内部存储类型
 	using container_t = std::map<const dim_t, T>;
 
+	/// 矩阵元素常量迭代器类型
+	using const_iterator = typename container_t::const_iterator;
+
 private:
 
 	/// 矩阵的维度信息
@@ -71,7 +149,62 @@ private:
 	/// 动态边界检查
 	static constexpr void dim_bound_check(dim_t const& t1, dim_t const& t2);
 
-	void check_row_min_max(size_t row, size_t cur);
+	/// @brief 行索引缓存
+	/// @details 复制或移动矩阵时缓存失效，避免引用另一矩阵的迭代器
+	struct row_index_t
+	{
+		/// 每行首元素的迭代器，长度为DimA + 1
+		std::vector<const_iterator> first;
+
+		/// 行偏移，长度为DimA + 1
+		std::vector<size_t> ptr;
+
+		/// 缓存是否有效，为真时first与ptr已完整写入
+		std::atomic<bool> valid{ false };
+
+		/// 重建时加锁，多个线程并发调用const的按行访问时只有一个线程重建
+		std::mutex lock;
+
+		row_index_t() = default;
+
+		row_index_t(row_index_t const&) noexcept {}
+
+		row_index_t& operator=(row_index_t const&) noexcept
+		{
+			first.clear();
+			ptr.clear();
+			valid = false;
+			return *this;
+		}
+	};
+
+	/// 行索引，插入新坐标时失效，首次按行访问时加锁重建，并发调用const的按行访问是安全的
+	mutable row_index_t row_index;
+
+	/// @brief 是否使用稠密行索引
+	/// @details 行数远大于元素个数时不建立索引，改为在存储上二分查找
+	/// @return 是否使用
+	bool use_row_index() const noexcept;
+
+	/// @brief 获取指定行的元素范围，不带边界检查
+	/// @return 首尾迭代器
+	/// @param r 行号
+	std::pair<const_iterator, const_iterator> row_range(size_t r) const;
+
+	/// @brief 按行列升序在末尾追加元素，不带边界检查
+	/// @details 调用者需保证坐标大于当前所有元素，插入为均摊O(1)
+	/// @param ele 值
+	/// @param DimAs 行坐标
+	/// @param DimBs 列坐标
+	void push_back_unchecked(T ele, size_t DimAs, size_t DimBs);
+
+	/// @brief 按行列顺序线性合并两个矩阵的元素，结果为0的元素不会被存储
+	/// @return 合并结果
+	/// @param m2 目标矩阵
+	/// @param f 合并函数，缺失的一方以T()代入
+	/// @tparam F 合并函数类型
+	template <typename F>
+	sparse_matrix2d<T, DimA, DimB> merge(sparse_matrix2d<T, DimA, DimB> const& m2, F&& f) const;
 
 protected:
 
@@ -87,12 +220,6 @@ protected:
 	/// @param DimBs 列坐标
 	void set_unchecked(T ele, size_t DimAs, size_t DimBs);
 
-	///行最小列下标
-	std::map<size_t, size_t> row_min;
-
-	///行最大列下标
-	std::map<size_t, size_t> row_max;
-
 public:
 
 	/// @brief 动态边界检查的设置
@@ -108,12 +235,32 @@ public:
 	template<size_t DimAs, size_t DimBs>
 	void set(T ele) noexcept;
 
+	/// @brief 由三元组数组批量构造
+	/// @details 一次排序后按序构建存储与行边界，重复坐标按输入顺序以combine合并，结果为0的元素不会被存储
+	/// @return 矩阵
+	/// @param rows 行坐标
+	/// @param cols 列坐标
+	/// @param vals 值
+	/// @param combine 重复坐标的合并函数
+	/// @tparam Combine 合并函数类型
+	template <typename Combine = std::plus<>>
+	static sparse_matrix2d<T, DimA, DimB> from_triplets(std::vector<size_t> const& rows, std::vector<size_t> const& cols, std::vector<T> const& vals, Combine combine = Combine());
+
 	/// @brief 动态边界检查的获取
 	/// @return 值
 	/// @param DimAg 行坐标
 	/// @param DimBg 列坐标
 	constexpr T get(size_t DimAg, size_t DimBg) const;
 
+	/// @brief 按半环解释未存储元素的动态边界检查的获取
+	/// @details 半环乘积不存储等于zero的元素，读取Mul<S>的结果时应使用此重载，如min_plus下不可达为无穷大而非0
+	/// @return 值，未存储时为S::zero()
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	/// @tparam S 半环
+	template <typename S>
+	constexpr T get(size_t DimAg, size_t DimBg) const;
+
 	/// @brief 静态边界检查的获取
 	/// @return 值
 	/// @tparam DimAg 行坐标
@@ -137,6 +284,7 @@ public:
 	constexpr bool have(T& out) const noexcept;
 
 	/// @brief 动态边界检查获取指定行
+	/// @details 经由行索引定位，为O(1)加上行长度；行索引为惰性构建的缓存，不应与写操作并发调用
 	/// @return 指定行
 	/// @param r 行号
 	constexpr std::vector<std::pair<size_t, T>> row(size_t r) const;
@@ -147,12 +295,31 @@ public:
 	template<size_t R>
 	constexpr std::vector<std::pair<size_t, T>> row() const noexcept;
 
+	/// @brief 动态边界检查获取指定行的非零元素个数
+	/// @return 元素个数
+	/// @param r 行号
+	size_t row_size(size_t r) const;
+
+	/// @brief 非零元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept;
+
+	/// @brief 按行列升序遍历的首迭代器
+	/// @return 首迭代器
+	const_iterator begin() const noexcept;
+
+	/// @brief 按行列升序遍历的尾迭代器
+	/// @return 尾迭代器
+	const_iterator end() const noexcept;
+
 	/// @brief AxB与BxC的矩阵乘积
+	/// @details 按行展开、排序、合并(Gustavson)，加法与乘法由半环给出，结果为半环zero的元素不会被存储
 	/// @return 乘积
 	/// @param m2 目标矩阵
+	/// @tparam S 半环，默认为普通加乘
 	/// @tparam DimC 矩阵2的列数
 	/// DimA 矩阵1的行数 DimB 矩阵1的列数即矩阵2的行数
-	template <size_t DimC>
+	template <typename S = plus_times<T>, size_t DimC>
 	constexpr sparse_matrix2d<T, DimA, DimC> Mul(sparse_matrix2d<T, DimB, DimC> const& m2) const noexcept;
 
 	/// @brief AxB的矩阵加法
@@ -169,11 +336,22 @@ public:
 	/// @tparam DimB 矩阵的列数
 	constexpr sparse_matrix2d<T, DimA, DimB> Sub(sparse_matrix2d<T, DimA, DimB> const& m2) const noexcept;
 
+	/// @brief AxB的矩阵线性组合 a*this + b*m2
+	/// @return 线性组合
+	/// @param a 本矩阵的系数
+	/// @param m2 目标矩阵
+	/// @param b 目标矩阵的系数
+	/// @tparam DimA 矩阵的行数
+	/// @tparam DimB 矩阵的列数
+	constexpr sparse_matrix2d<T, DimA, DimB> Axpby(T a, sparse_matrix2d<T, DimA, DimB> const& m2, T b) const noexcept;
+
 	/// @brief AxB的矩阵转置
+	/// @details 使用transpose_order计数排序后按序构建，不再逐个随机插入
 	/// @return 转置
+	/// @param threads 线程数，为0时使用硬件并发数
 	/// @tparam DimA 矩阵的行数
 	/// @tparam DimB 矩阵的列数
-	constexpr sparse_matrix2d<T, DimB, DimA> Rev() const noexcept;
+	constexpr sparse_matrix2d<T, DimB, DimA> Rev(size_t threads = 1) const noexcept;
 
 	/// @brief AxB的矩阵输出
 	/// @return 原输出流
@@ -198,28 +376,56 @@ constexpr sparse_matrix2d<T, DimA, DimB>::sparse_matrix2d(const T (&Args)[A][B])
 	static_assert(B == DimB, "Col size doesn't match");
 	for (size_t i = 0; i != DimA; ++i) {
 		for (size_t j = 0; j != DimB; ++j) {
-			if(Args[i][j])set_unchecked(Args[i][j], i, j);
+			if(Args[i][j])push_back_unchecked(Args[i][j], i, j);
 		}
 	}
 }
 
 template <typename T, size_t DimA, size_t DimB>
-void sparse_matrix2d<T, DimA, DimB>::check_row_min_max(size_t row, size_t cur)
+bool sparse_matrix2d<T, DimA, DimB>::use_row_index() const noexcept
 {
-	auto it = row_max.find(row);
-	if(!(it!=row_max.end() && it->second >= cur)) {
-		row_max.insert_or_assign(row, cur);
+	return DimA <= 4 * container.size() + 1024;
+}
+
+template <typename T, size_t DimA, size_t DimB>
+std::pair<typename sparse_matrix2d<T, DimA, DimB>::const_iterator, typename sparse_matrix2d<T, DimA, DimB>::const_iterator> sparse_matrix2d<T, DimA, DimB>::row_range(size_t r) const
+{
+	if (!use_row_index()) {
+		return std::make_pair(container.lower_bound(std::make_tuple(r, size_t(0))), container.lower_bound(std::make_tuple(r + 1, size_t(0))));
 	}
-	it = row_min.find(row);
-	if (!(it != row_min.end() && it->second <= cur)) {
-		row_min.insert_or_assign(row, cur);
+	if (!row_index.valid.load(std::memory_order_acquire)) {
+		auto guard = std::lock_guard<std::mutex>(row_index.lock);
+		if (row_index.valid.load(std::memory_order_relaxed)) {
+			return std::make_pair(row_index.first[r], row_index.first[r + 1]);
+		}
+		auto& first = row_index.first;
+		auto& ptr = row_index.ptr;
+		first.assign(DimA + 1, container.end());
+		ptr.assign(DimA + 1, container.size());
+		size_t k = 0;
+		size_t i = 0;
+		for (auto it = container.begin(); it != container.end(); ++it, ++k) {
+			for (auto r2 = std::get<0>(it->first); i <= r2; ++i) {
+				first[i] = it;
+				ptr[i] = k;
+			}
+		}
+		row_index.valid.store(true, std::memory_order_release);
 	}
+	return std::make_pair(row_index.first[r], row_index.first[r + 1]);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+void sparse_matrix2d<T, DimA, DimB>::push_back_unchecked(T ele, size_t DimAs, size_t DimBs)
+{
+	container.emplace_hint(container.end(), std::make_tuple(DimAs, DimBs), ele);
+	row_index.valid = false;
 }
 
 template <typename T, size_t DimA, size_t DimB>
 constexpr void sparse_matrix2d<T, DimA, DimB>::dim_bound_check(dim_t const& t1, dim_t const& t2)
 {
-	if (std::get<0>(t1) < std::get<0>(t2) || std::get<1>(t1) < std::get<1>(t2)) {
+	if (std::get<0>(t1) <= std::get<0>(t2) || std::get<1>(t1) <= std::get<1>(t2)) {
 		throw std::out_of_range("Matrix bound check failed");
 	}
 }
@@ -227,8 +433,9 @@ constexpr void sparse_matrix2d<T, DimA, DimB>::dim_bound_check(dim_t const& t1,
 template <typename T, size_t DimA, size_t DimB>
 void sparse_matrix2d<T, DimA, DimB>::set_unchecked(T ele, size_t DimAs, size_t DimBs)
 {
-	container.insert_or_assign(std::make_tuple(DimAs, DimBs), ele);
-	check_row_min_max(DimAs, DimBs);
+	if (container.insert_or_assign(std::make_tuple(DimAs, DimBs), ele).second) {
+		row_index.valid = false;
+	}
 }
 
 template <typename T, size_t DimA, size_t DimB>
@@ -258,6 +465,52 @@ void sparse_matrix2d<T, DimA, DimB>::set(T ele) noexcept
 	set_unchecked(ele, DimAs, DimBs);
 }
 
+template <typename T, size_t DimA, size_t DimB>
+template <typename Combine>
+sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::from_triplets(std::vector<size_t> const& rows, std::vector<size_t> const& cols, std::vector<T> const& vals, Combine combine)
+{
+	auto n = vals.size();
+	if (rows.size() != n || cols.size() != n) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	for (size_t k = 0; k != n; ++k) {
+		if (DimA <= rows[k] || DimB <= cols[k]) {
+			throw std::out_of_range("Matrix bound check failed");
+		}
+	}
+
+	auto order = std::vector<size_t>(n);
+	if (DimB == 0 || DimA <= std::numeric_limits<uint64_t>::max() / DimB) {
+		auto keys = std::vector<std::pair<uint64_t, size_t>>(n);
+		for (size_t k = 0; k != n; ++k) {
+			keys[k] = std::make_pair(uint64_t(rows[k]) * DimB + cols[k], k);
+		}
+		std::sort(keys.begin(), keys.end());
+		for (size_t k = 0; k != n; ++k) {
+			order[k] = keys[k].second;
+		}
+	} else {
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::sort(order.begin(), order.end(), [&rows, &cols](size_t a, size_t b) {
+			return std::tie(rows[a], cols[a], a) < std::tie(rows[b], cols[b], b);
+		});
+	}
+
+	sparse_matrix2d<T, DimA, DimB> res;
+	for (size_t k = 0; k != n;) {
+		auto r = rows[order[k]];
+		auto c = cols[order[k]];
+		auto v = vals[order[k]];
+		while (++k != n && rows[order[k]] == r && cols[order[k]] == c) {
+			v = combine(v, vals[order[k]]);
+		}
+		if (v != T()) {
+			res.push_back_unchecked(v, r, c);
+		}
+	}
+	return res;
+}
+
 template <typename T, size_t DimA, size_t DimB>
 constexpr T sparse_matrix2d<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
 {
@@ -266,6 +519,14 @@ constexpr T sparse_matrix2d<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) cons
 	return get_unchecked(DimAg, DimBg);
 }
 
+template <typename T, size_t DimA, size_t DimB>
+template <typename S>
+constexpr T sparse_matrix2d<T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	auto out = T();
+	return have(DimAg, DimBg, out) ? out : S::zero();
+}
+
 template <typename T, size_t DimA, size_t DimB>
 template<size_t DimAg, size_t DimBg>
 constexpr T sparse_matrix2d<T, DimA, DimB>::get() const noexcept
@@ -309,15 +570,9 @@ constexpr std::vector<std::pair<size_t, T>> sparse_matrix2d<T, DimA, DimB>::row(
 {
 	static_assert(R < DimA, "Matrix bound check failed");
 	auto ret = std::vector<std::pair<size_t, T>>();
-	auto it = row_min.find(R);
-	if(it == row_min.end()) {
-		return ret;
-	}
-	auto min = container.find(std::make_tuple(R, it->second));
-	auto max = ++container.find(std::make_tuple(R, row_max.at(R)));
-
-	for(; min!=max; ++min) {
-		ret.emplace_back(std::get<1>(min->first), min->second);
+	auto range = row_range(R);
+	for (auto it = range.first; it != range.second; ++it) {
+		ret.emplace_back(std::get<1>(it->first), it->second);
 	}
 	return ret;
 }
@@ -329,36 +584,73 @@ constexpr std::vector<std::pair<size_t, T>> sparse_matrix2d<T, DimA, DimB>::row(
 		throw std::out_of_range("Matrix bound check failed");
 	}
 	auto ret = std::vector<std::pair<size_t, T>>();
-	auto it = row_min.find(r);
-	if (it == row_min.end()) {
-		return ret;
+	auto range = row_range(r);
+	if (use_row_index()) {
+		ret.reserve(row_index.ptr[r + 1] - row_index.ptr[r]);
 	}
-	auto min = container.find(std::make_tuple(r, it->second));
-	auto max = ++container.find(std::make_tuple(r, row_max.at(r)));
-
-	for (; min != max; ++min) {
-		ret.emplace_back(std::get<1>(min->first), min->second);
+	for (auto it = range.first; it != range.second; ++it) {
+		ret.emplace_back(std::get<1>(it->first), it->second);
 	}
 	return ret;
 }
 
 template <typename T, size_t DimA, size_t DimB>
-template <size_t DimC>
+size_t sparse_matrix2d<T, DimA, DimB>::row_size(size_t r) const
+{
+	if (DimA <= r) {
+		throw std::out_of_range("Matrix bound check failed");
+	}
+	auto range = row_range(r);
+	if (use_row_index()) {
+		return row_index.ptr[r + 1] - row_index.ptr[r];
+	}
+	return std::distance(range.first, range.second);
+}
+
+template <typename T, size_t DimA, size_t DimB>
+size_t sparse_matrix2d<T, DimA, DimB>::size() const noexcept
+{
+	return container.size();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+typename sparse_matrix2d<T, DimA, DimB>::const_iterator sparse_matrix2d<T, DimA, DimB>::begin() const noexcept
+{
+	return container.begin();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+typename sparse_matrix2d<T, DimA, DimB>::const_iterator sparse_matrix2d<T, DimA, DimB>::end() const noexcept
+{
+	return container.end();
+}
+
+template <typename T, size_t DimA, size_t DimB>
+template <typename S, size_t DimC>
 constexpr sparse_matrix2d<T, DimA, DimC> sparse_matrix2d<T, DimA, DimB>::Mul(sparse_matrix2d<T, DimB, DimC> const& m2) const noexcept
 {
 	sparse_matrix2d<T, DimA, DimC> res;
-	for (auto ele : container) {
-		size_t Da = std::get<0>(ele.first);
-		for (size_t i = 0; i != DimC; ++i) {
-			T a = T();
-			for (size_t j = 0; j != DimB; ++j) {
-				T val = T();
-				if ((val = m2.get_unchecked(j, i)) != 0) {
-					a += ele.second*val;
-				}
+	auto acc = std::vector<std::pair<size_t, T>>();
+	for (auto it = container.begin(); it != container.end();) {
+		auto r = std::get<0>(it->first);
+		acc.clear();
+		for (; it != container.end() && std::get<0>(it->first) == r; ++it) {
+			auto range = m2.row_range(std::get<1>(it->first));
+			for (auto jt = range.first; jt != range.second; ++jt) {
+				acc.emplace_back(std::get<1>(jt->first), S::mul(it->second, jt->second));
 			}
-			if ((a = res.get_unchecked(Da, i) + a) != 0) {
-				res.set_unchecked(a, Da, i);
+		}
+		std::stable_sort(acc.begin(), acc.end(), [](std::pair<size_t, T> const& a, std::pair<size_t, T> const& b) {
+			return a.first < b.first;
+		});
+		for (size_t k = 0; k != acc.size();) {
+			auto c = acc[k].first;
+			auto v = acc[k].second;
+			while (++k != acc.size() && acc[k].first == c) {
+				v = S::add(v, acc[k].second);
+			}
+			if (v != S::zero()) {
+				res.push_back_unchecked(v, r, c);
 			}
 		}
 	}
@@ -366,55 +658,305 @@ constexpr sparse_matrix2d<T, DimA, DimC> sparse_matrix2d<T, DimA, DimB>::Mul(spa
 }
 
 template <typename T, size_t DimA, size_t DimB>
-constexpr sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::Add(sparse_matrix2d<T, DimA, DimB> const& m2) const noexcept {
+template <typename F>
+sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::merge(sparse_matrix2d<T, DimA, DimB> const& m2, F&& f) const
+{
 	sparse_matrix2d<T, DimA, DimB> res;
-	for (auto ele : container) {
-		res.set_unchecked(ele.second, std::get<0>(ele.first), std::get<1>(ele.first));
-	}
-	for (auto ele : m2.container) {
-		res.set_unchecked(res.get_unchecked(std::get<0>(ele.first), std::get<1>(ele.first)) + ele.second, std::get<0>(ele.first), std::get<1>(ele.first));
+	auto i = container.begin();
+	auto j = m2.container.begin();
+	while (i != container.end() || j != m2.container.end()) {
+		T val;
+		dim_t const* pos;
+		if (j == m2.container.end() || (i != container.end() && i->first < j->first)) {
+			val = f(i->second, T());
+			pos = &i->first;
+			++i;
+		} else if (i == container.end() || j->first < i->first) {
+			val = f(T(), j->second);
+			pos = &j->first;
+			++j;
+		} else {
+			val = f(i->second, j->second);
+			pos = &i->first;
+			++i;
+			++j;
+		}
+		if (val != T()) {
+			res.push_back_unchecked(val, std::get<0>(*pos), std::get<1>(*pos));
+		}
 	}
 	return res;
 }
 
+template <typename T, size_t DimA, size_t DimB>
+constexpr sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::Add(sparse_matrix2d<T, DimA, DimB> const& m2) const noexcept {
+	return merge(m2, [](T x, T y) { return x + y; });
+}
+
 template <typename T, size_t DimA, size_t DimB>
 constexpr sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::Sub(sparse_matrix2d<T, DimA, DimB> const& m2) const noexcept {
-	sparse_matrix2d<T, DimA, DimB> res;
-	for (auto ele : container) {
-		res.set_unchecked(ele.second, std::get<0>(ele.first), std::get<1>(ele.first));
+	return merge(m2, [](T x, T y) { return x - y; });
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr sparse_matrix2d<T, DimA, DimB> sparse_matrix2d<T, DimA, DimB>::Axpby(T a, sparse_matrix2d<T, DimA, DimB> const& m2, T b) const noexcept {
+	return merge(m2, [a, b](T x, T y) { return a * x + b * y; });
+}
+
+template <typename T, size_t DimA, size_t DimB>
+constexpr sparse_matrix2d<T, DimB, DimA> sparse_matrix2d<T, DimA, DimB>::Rev(size_t threads) const noexcept
+{
+	sparse_matrix2d<T, DimB, DimA> res;
+	auto rows = std::vector<size_t>();
+	auto cols = std::vector<size_t>();
+	auto vals = std::vector<T>();
+	rows.reserve(container.size());
+	cols.reserve(container.size());
+	vals.reserve(container.size());
+	for (auto const& ele : container) {
+		rows.push_back(std::get<0>(ele.first));
+		cols.push_back(std::get<1>(ele.first));
+		vals.push_back(ele.second);
 	}
-	for (auto ele : m2.container) {
-		res.set_unchecked(res.get_unchecked(std::get<0>(ele.first), std::get<1>(ele.first)) - ele.second, std::get<0>(ele.first), std::get<1>(ele.first));
+	for (auto k : transpose_order(cols, DimB, threads)) {
+		res.push_back_unchecked(vals[k], cols[k], rows[k]);
 	}
 	return res;
 }
 
+/// @brief 稀疏矩阵线性表达式的维度信息
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
 template <typename T, size_t DimA, size_t DimB>
-constexpr sparse_matrix2d<T, DimB, DimA> sparse_matrix2d<T, DimA, DimB>::Rev() const noexcept
+struct sparse_dims
 {
-	sparse_matrix2d<T, DimB, DimA> res;
-	for (auto ele : container) {
-		res.set_unchecked(ele.second, std::get<1>(ele.first), std::get<0>(ele.first));
+	using value_type = T;
+	static constexpr size_t rows = DimA;
+	static constexpr size_t cols = DimB;
+};
+
+template <typename T, size_t DimA, size_t DimB>
+sparse_dims<T, DimA, DimB> sparse_dims_of(sparse_matrix2d<T, DimA, DimB> const&);
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+sparse_dims<T, DimA, DimB> sparse_dims_of(sparse_matrix2d_expr<E, T, DimA, DimB> const&);
+
+/// 矩阵或惰性表达式的维度信息，其他类型将导致替换失败
+template <typename X>
+using sparse_dims_t = decltype(sparse_dims_of(std::declval<typename std::decay<X>::type const&>()));
+
+template <typename X>
+struct is_sparse_matrix2d : std::false_type {};
+
+template <typename T, size_t DimA, size_t DimB>
+struct is_sparse_matrix2d<sparse_matrix2d<T, DimA, DimB>> : std::true_type {};
+
+/// @brief 表达式操作数的存储类型
+/// @details 左值矩阵按引用保存，右值矩阵与子表达式按值保存，避免悬垂引用
+template <typename X>
+using sparse_hold_t = typename std::conditional<
+	std::is_lvalue_reference<X>::value && is_sparse_matrix2d<typename std::decay<X>::type>::value,
+	typename std::decay<X>::type const&,
+	typename std::decay<X>::type>::type;
+
+template <typename T, size_t DimA, size_t DimB>
+void sparse_collect(sparse_matrix2d<T, DimA, DimB> const& m, T coef, std::vector<std::pair<T, sparse_matrix2d<T, DimA, DimB> const*>>& terms)
+{
+	terms.emplace_back(coef, &m);
+}
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+void sparse_collect(sparse_matrix2d_expr<E, T, DimA, DimB> const& e, T coef, std::vector<std::pair<T, sparse_matrix2d<T, DimA, DimB> const*>>& terms)
+{
+	static_cast<E const&>(e).collect(coef, terms);
+}
+
+/// @brief 稀疏矩阵的惰性线性表达式
+/// @details
+/// 加、减与数乘不会立即计算，而是在赋值给sparse_matrix2d时
+/// 将整个表达式展开为若干带系数的矩阵，一次多路归并求值
+/// @tparam E 派生表达式类型
+/// @tparam T 矩阵元素类型
+/// @tparam DimA 矩阵行数
+/// @tparam DimB 矩阵列数
+template <typename E, typename T, size_t DimA, size_t DimB>
+class sparse_matrix2d_expr
+{
+public:
+	/// 展开后的带系数矩阵列表类型
+	using terms_t = std::vector<std::pair<T, sparse_matrix2d<T, DimA, DimB> const*>>;
+
+	/// @brief 求值
+	/// @return 表达式的值，结果为0的元素不会被存储
+	sparse_matrix2d<T, DimA, DimB> eval() const;
+
+	/// @brief 动态边界检查的获取，仅计算单个元素
+	/// @return 值
+	/// @param DimAg 行坐标
+	/// @param DimBg 列坐标
+	T get(size_t DimAg, size_t DimBg) const;
+
+	/// @brief 静态边界检查的获取，仅计算单个元素
+	/// @return 值
+	/// @tparam DimAg 行坐标
+	/// @tparam DimBg 列坐标
+	template<size_t DimAg, size_t DimBg>
+	T get() const noexcept;
+};
+
+/// @brief 加减法表达式 lhs + rc * rhs
+template <typename T, size_t DimA, size_t DimB, typename L, typename R>
+class sparse_matrix2d_sum : public sparse_matrix2d_expr<sparse_matrix2d_sum<T, DimA, DimB, L, R>, T, DimA, DimB>
+{
+	L lhs;
+	R rhs;
+	T rc;
+
+public:
+	template <typename X, typename Y>
+	sparse_matrix2d_sum(X&& l, Y&& r, T rc) : lhs(std::forward<X>(l)), rhs(std::forward<Y>(r)), rc(rc) {}
+
+	void collect(T coef, typename sparse_matrix2d_sum::terms_t& terms) const
+	{
+		sparse_collect(lhs, coef, terms);
+		sparse_collect(rhs, coef * rc, terms);
+	}
+};
+
+/// @brief 数乘表达式 c * e
+template <typename T, size_t DimA, size_t DimB, typename E>
+class sparse_matrix2d_scale : public sparse_matrix2d_expr<sparse_matrix2d_scale<T, DimA, DimB, E>, T, DimA, DimB>
+{
+	E e;
+	T c;
+
+public:
+	template <typename X>
+	sparse_matrix2d_scale(X&& e, T c) : e(std::forward<X>(e)), c(c) {}
+
+	void collect(T coef, typename sparse_matrix2d_scale::terms_t& terms) const
+	{
+		sparse_collect(e, coef * c, terms);
+	}
+};
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> sparse_matrix2d_expr<E, T, DimA, DimB>::eval() const
+{
+	using matrix_t = sparse_matrix2d<T, DimA, DimB>;
+	auto terms = terms_t();
+	sparse_collect(*this, T(1), terms);
+	auto its = std::vector<typename matrix_t::const_iterator>();
+	its.reserve(terms.size());
+	for (auto const& t : terms) {
+		its.push_back(t.second->begin());
+	}
+	matrix_t res;
+	while (true) {
+		typename matrix_t::dim_t const* pos = nullptr;
+		for (size_t i = 0; i != terms.size(); ++i) {
+			if (its[i] != terms[i].second->end() && (!pos || its[i]->first < *pos)) {
+				pos = &its[i]->first;
+			}
+		}
+		if (!pos) {
+			break;
+		}
+		auto key = *pos;
+		T val = T();
+		for (size_t i = 0; i != terms.size(); ++i) {
+			if (its[i] != terms[i].second->end() && its[i]->first == key) {
+				val += terms[i].first * its[i]->second;
+				++its[i];
+			}
+		}
+		if (val != T()) {
+			res.push_back_unchecked(val, std::get<0>(key), std::get<1>(key));
+		}
 	}
 	return res;
 }
 
+template <typename E, typename T, size_t DimA, size_t DimB>
+T sparse_matrix2d_expr<E, T, DimA, DimB>::get(size_t DimAg, size_t DimBg) const
+{
+	auto terms = terms_t();
+	sparse_collect(*this, T(1), terms);
+	T val = T();
+	for (auto const& t : terms) {
+		val += t.first * t.second->get(DimAg, DimBg);
+	}
+	return val;
+}
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+template<size_t DimAg, size_t DimBg>
+T sparse_matrix2d_expr<E, T, DimA, DimB>::get() const noexcept
+{
+	static_assert(dim_bound_check_static<DimA, DimB>(DimAg, DimBg), "Matrix bound check failed");
+	return get(DimAg, DimBg);
+}
+
 template <typename T, size_t DimA, size_t DimB>
-constexpr sparse_matrix2d<T, DimA, DimB> operator+(sparse_matrix2d<T, DimA, DimB> const& a, sparse_matrix2d<T, DimA, DimB> const& b) noexcept
+template <typename E>
+sparse_matrix2d<T, DimA, DimB>::sparse_matrix2d(sparse_matrix2d_expr<E, T, DimA, DimB> const& e) : sparse_matrix2d(e.eval())
+{ }
+
+template <typename L, typename R, typename DL = sparse_dims_t<L>, typename DR = sparse_dims_t<R>>
+sparse_matrix2d_sum<typename DL::value_type, DL::rows, DL::cols, sparse_hold_t<L>, sparse_hold_t<R>> operator+(L&& a, R&& b)
+{
+	static_assert(std::is_same<typename DL::value_type, typename DR::value_type>::value, "Matrix type doesn't match");
+	static_assert(DL::rows == DR::rows, "Row size doesn't match");
+	static_assert(DL::cols == DR::cols, "Col size doesn't match");
+	return { std::forward<L>(a), std::forward<R>(b), typename DL::value_type(1) };
+}
+
+template <typename L, typename R, typename DL = sparse_dims_t<L>, typename DR = sparse_dims_t<R>>
+sparse_matrix2d_sum<typename DL::value_type, DL::rows, DL::cols, sparse_hold_t<L>, sparse_hold_t<R>> operator-(L&& a, R&& b)
+{
+	static_assert(std::is_same<typename DL::value_type, typename DR::value_type>::value, "Matrix type doesn't match");
+	static_assert(DL::rows == DR::rows, "Row size doesn't match");
+	static_assert(DL::cols == DR::cols, "Col size doesn't match");
+	return { std::forward<L>(a), std::forward<R>(b), typename DL::value_type(-1) };
+}
+
+template <typename X, typename D = sparse_dims_t<X>>
+sparse_matrix2d_scale<typename D::value_type, D::rows, D::cols, sparse_hold_t<X>> operator*(typename D::value_type c, X&& e)
+{
+	return { std::forward<X>(e), c };
+}
+
+template <typename X, typename D = sparse_dims_t<X>>
+sparse_matrix2d_scale<typename D::value_type, D::rows, D::cols, sparse_hold_t<X>> operator*(X&& e, typename D::value_type c)
 {
-	return a.Add(b);
+	return { std::forward<X>(e), c };
 }
 
 template <typename T, size_t DimA, size_t DimB>
-constexpr sparse_matrix2d<T, DimA, DimB> operator-(sparse_matrix2d<T, DimA, DimB> const& a, sparse_matrix2d<T, DimA, DimB> const& b) noexcept
+sparse_matrix2d<T, DimA, DimB> const& sparse_eval(sparse_matrix2d<T, DimA, DimB> const& m) noexcept
 {
-	return a.Sub(b);
+	return m;
 }
 
-template <typename T, size_t DimA, size_t DimB, size_t DimC>
-constexpr sparse_matrix2d<T, DimA, DimC> operator*(sparse_matrix2d<T, DimA, DimB> const& a, sparse_matrix2d<T, DimB, DimC> const& b) noexcept
+template <typename E, typename T, size_t DimA, size_t DimB>
+sparse_matrix2d<T, DimA, DimB> sparse_eval(sparse_matrix2d_expr<E, T, DimA, DimB> const& e)
 {
-	return a.Mul(b);
+	return e.eval();
+}
+
+template <typename L, typename R, typename DL = sparse_dims_t<L>, typename DR = sparse_dims_t<R>>
+sparse_matrix2d<typename DL::value_type, DL::rows, DR::cols> operator*(L&& a, R&& b)
+{
+	static_assert(std::is_same<typename DL::value_type, typename DR::value_type>::value, "Matrix type doesn't match");
+	static_assert(DL::cols == DR::rows, "Matrix size doesn't match");
+	return sparse_eval(a).Mul(sparse_eval(b));
+}
+
+template <typename E, typename T, size_t DimA, size_t DimB>
+std::ostream& operator<< (std::ostream& out, sparse_matrix2d_expr<E, T, DimA, DimB> const& e)
+{
+	return out << e.eval();
 }
 
 template <typename T, size_t DimA, size_t DimB>
@@ -430,16 +972,138 @@ std::ostream& operator<< (std::ostream& out, sparse_matrix2d<T, DimA, DimB> cons
 }
 
 #ifdef Use_FoldExp
+/// @brief 各维度之积是否能以64位无符号整数表示
+/// @tparam Dims 各维度大小
+template <size_t ...Dims>
+constexpr bool dim_product_fits() {
+	uint64_t p = 1;
+	for (uint64_t d : { uint64_t(Dims)... }) {
+		if (d != 0 && p > std::numeric_limits<uint64_t>::max() / d) {
+			return false;
+		}
+		p *= d;
+	}
+	return true;
+}
+
+/// @brief 以64位线性坐标为键的开放寻址哈希表
+/// @details
+/// 线性探测，容量为2的幂，装载因子不超过0.7；全1的键保留为空槽标记
+/// @tparam T 值类型
+template <typename T>
+class sparse_hash_table
+{
+	/// 空槽标记
+	static constexpr uint64_t empty = std::numeric_limits<uint64_t>::max();
+
+	std::vector<uint64_t> keys;
+	std::vector<T> vals;
+	size_t count = 0;
+
+	static uint64_t mix(uint64_t x) noexcept
+	{
+		x ^= x >> 30;
+		x *= 0xbf58476d1ce4e5b9ULL;
+		x ^= x >> 27;
+		x *= 0x94d049bb133111ebULL;
+		return x ^ (x >> 31);
+	}
+
+	size_t slot(uint64_t key) const noexcept
+	{
+		auto mask = keys.size() - 1;
+		auto i = static_cast<size_t>(mix(key)) & mask;
+		while (keys[i] != empty && keys[i] != key) {
+			i = (i + 1) & mask;
+		}
+		return i;
+	}
+
+	void grow()
+	{
+		auto old_keys = std::move(keys);
+		auto old_vals = std::move(vals);
+		keys.assign(old_keys.empty() ? 16 : old_keys.size() * 2, empty);
+		vals.assign(keys.size(), T());
+		for (size_t i = 0; i != old_keys.size(); ++i) {
+			if (old_keys[i] != empty) {
+				auto s = slot(old_keys[i]);
+				keys[s] = old_keys[i];
+				vals[s] = std::move(old_vals[i]);
+			}
+		}
+	}
+
+public:
+	/// @brief 查找
+	/// @return 指向值的指针，不存在时为nullptr
+	/// @param key 线性坐标
+	T const* find(uint64_t key) const noexcept
+	{
+		if (keys.empty()) {
+			return nullptr;
+		}
+		auto s = slot(key);
+		return keys[s] == key ? &vals[s] : nullptr;
+	}
+
+	/// @brief 插入或覆盖
+	/// @param key 线性坐标
+	/// @param val 值
+	void insert_or_assign(uint64_t key, T val)
+	{
+		if ((count + 1) * 10 > keys.size() * 7) {
+			grow();
+		}
+		auto s = slot(key);
+		if (keys[s] == empty) {
+			keys[s] = key;
+			++count;
+		}
+		vals[s] = std::move(val);
+	}
+
+	/// @brief 元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept
+	{
+		return count;
+	}
+
+	/// @brief 按线性坐标升序导出
+	/// @return (线性坐标, 值)序列
+	std::vector<std::pair<uint64_t, T>> sorted() const
+	{
+		auto ret = std::vector<std::pair<uint64_t, T>>();
+		ret.reserve(count);
+		for (size_t i = 0; i != keys.size(); ++i) {
+			if (keys[i] != empty) {
+				ret.emplace_back(keys[i], vals[i]);
+			}
+		}
+		std::sort(ret.begin(), ret.end(), [](auto const& a, auto const& b) { return a.first < b.first; });
+		return ret;
+	}
+};
+
+/// @brief N维稀疏张量
+/// @details
+/// 坐标按行主序线性化为64位整数，存储于开放寻址哈希表，单点读写期望O(1)
+/// @tparam T 元素类型
+/// @tparam Dims 各维度大小
 template <typename T, size_t ...Dims>
 class sparse_matrix
 {
+	static_assert(sizeof...(Dims) != 0, "At least one dimension required");
+	static_assert(dim_product_fits<Dims...>(), "Dimension product doesn't fit in 64 bits");
+
 public:
 	template<typename, size_t ...> friend class sparse_matrix;
 	using dim_t = std::tuple<decltype(Dims)...>;
 	using item_t = std::tuple<T, const dim_t>;
 
 private:
-	std::map<const dim_t, T> container;
+	sparse_hash_table<T> container;
 
 	static const dim_t dim_tuple;
 
@@ -450,6 +1114,13 @@ private:
 	typename std::enable_if < I < std::tuple_size<dim_t>::value, void>::type
 		static constexpr dim_bound_check(dim_t const& t1, dim_t const& t2);
 
+	/// @brief 行主序线性化坐标
+	static constexpr uint64_t linearize(decltype(Dims)... args) noexcept;
+
+	/// @brief 由线性坐标还原坐标
+	template<size_t ...I>
+	static dim_t delinearize(uint64_t idx, std::index_sequence<I...>) noexcept;
+
 public:
 	void set(T ele, decltype(Dims)... args);
 
@@ -460,6 +1131,14 @@ public:
 
 	template<decltype(Dims)... Args>
 	T get() const noexcept;
+
+	/// @brief 元素个数
+	/// @return 存储的元素个数
+	size_t size() const noexcept;
+
+	/// @brief 按坐标字典序导出的COO三元组，可供流式缩并
+	/// @return (坐标, 值)序列
+	std::vector<std::pair<dim_t, T>> to_coo() const;
 };
 
 template <typename T, size_t ...Dims>
@@ -478,18 +1157,39 @@ typename std::enable_if < I < std::tuple_size<typename  sparse_matrix< T, Dims..
 {
 	auto x = std::get<I>(t1);
 	auto y = std::get<I>(t2);
-	if (x < y) {
+	if (x <= y) {
 		throw std::out_of_range("Matrix bound check failed");
 	}
 	dim_bound_check<I + 1>(t1, t2);
 }
 
+template <typename T, size_t ...Dims>
+constexpr uint64_t sparse_matrix< T, Dims...>::linearize(decltype(Dims)... args) noexcept
+{
+	uint64_t idx = 0;
+	((idx = idx * Dims + args), ...);
+	return idx;
+}
+
+template <typename T, size_t ...Dims>
+template<size_t ...I>
+typename sparse_matrix< T, Dims...>::dim_t sparse_matrix< T, Dims...>::delinearize(uint64_t idx, std::index_sequence<I...>) noexcept
+{
+	constexpr size_t dims[] = { Dims... };
+	size_t ret[sizeof...(Dims)];
+	for (auto k = sizeof...(Dims); k-- != 0;) {
+		ret[k] = static_cast<size_t>(idx % dims[k]);
+		idx /= dims[k];
+	}
+	return std::make_tuple(ret[I]...);
+}
+
 template <typename T, size_t ...Dims>
 void sparse_matrix< T, Dims...>::set(T ele, decltype(Dims)... args)
 {
 	dim_t i = std::make_tuple(args...);
 	dim_bound_check(dim_tuple, i);
-	container.insert_or_assign(i, ele);
+	container.insert_or_assign(linearize(args...), ele);
 }
 
 template <typename T, size_t ...Dims>
@@ -497,8 +1197,7 @@ template<decltype(Dims)... Args>
 void sparse_matrix< T, Dims...>::set(T ele)
 {
 	static_assert(dim_bound_check_static<Dims...>(Args...), "Matrix bound check failed");
-	dim_t i = std::make_tuple(Args...);
-	container.insert_or_assign(i, ele);
+	container.insert_or_assign(linearize(Args...), ele);
 }
 
 template <typename T, size_t ...Dims>
@@ -506,9 +1205,9 @@ T sparse_matrix< T, Dims...>::get(decltype(Dims)... args) const
 {
 	dim_t i = std::make_tuple(args...);
 	dim_bound_check(dim_tuple, i);
-	auto x = container.find(i);
-	if (x != container.end()) {
-		return x->second;
+	auto x = container.find(linearize(args...));
+	if (x) {
+		return *x;
 	}
 	return T();
 }
@@ -518,13 +1217,30 @@ template<decltype(Dims)... Args>
 T sparse_matrix< T, Dims...>::get() const noexcept
 {
 	static_assert(dim_bound_check_static<Dims...>(Args...), "Matrix bound check failed");
-	dim_t i = std::make_tuple(Args...);
-	auto x = container.find(i);
-	if (x != container.end()) {
-		return x->second;
+	auto x = container.find(linearize(Args...));
+	if (x) {
+		return *x;
 	}
 	return T();
 }
+
+template <typename T, size_t ...Dims>
+size_t sparse_matrix< T, Dims...>::size() const noexcept
+{
+	return container.size();
+}
+
+template <typename T, size_t ...Dims>
+std::vector<std::pair<typename sparse_matrix< T, Dims...>::dim_t, T>> sparse_matrix< T, Dims...>::to_coo() const
+{
+	auto ret = std::vector<std::pair<dim_t, T>>();
+	auto items = container.sorted();
+	ret.reserve(items.size());
+	for (auto const& it : items) {
+		ret.emplace_back(delinearize(it.first, std::index_sequence_for<decltype(Dims)...>()), it.second);
+	}
+	return ret;
+}
 #endif
 
 #define sparse_matrix_defined
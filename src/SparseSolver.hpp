@@ -0,0 +1,214 @@
+#pragma once
+
+#ifndef SparseSolver_disabled
+
+#ifndef SparseSolver_defined
+// ReSharper disable CppUnusedIncludeDirective
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "Parallel.hpp"
+#include "SparseMatrix.hpp"
+#include "CsrMatrix.hpp"
+
+/// @brief 迭代求解的结果
+/// @tparam T 元素类型
+template <typename T>
+struct solver_result
+{
+	/// 解向量或特征向量
+	std::vector<T> x;
+
+	/// 共轭梯度法为最终残差范数，幂迭代为主特征值
+	T value;
+
+	/// 迭代次数
+	size_t iterations;
+
+	/// 是否在最大迭代次数内收敛
+	bool converged;
+};
+
+/// @brief 常驻线程组内的归约求和
+/// @details
+/// 各线程写入自己的部分和，经一次屏障后按线程号顺序相加，所有线程得到完全相同的结果，迭代的分支因而一致；
+/// 部分和交替写入两组缓冲，下一次求和写入另一组，因此相邻两次求和之间不需要额外的屏障
+/// @tparam T 元素类型
+template <typename T>
+class solver_sum
+{
+	/// 两组部分和
+	std::vector<T> part;
+
+	/// 各线程已完成的求和次数
+	std::vector<size_t> phase;
+
+	/// 线程数
+	size_t threads;
+
+public:
+	/// @brief 构造
+	/// @param threads 线程数
+	explicit solver_sum(size_t threads) : part(2 * threads), phase(threads, 0), threads(threads) {}
+
+	/// @brief 所有线程共同求和，每个线程都需调用
+	/// @return 所有线程部分和的总和
+	/// @param i 线程号
+	/// @param s 本线程的部分和
+	/// @param sync 线程组的屏障
+	T operator()(size_t i, T s, parallel_barrier& sync)
+	{
+		auto buf = part.data() + (phase[i]++ % 2) * threads;
+		buf[i] = s;
+		sync.wait();
+		T total = T();
+		for (size_t k = 0; k != threads; ++k) {
+			total += buf[k];
+		}
+		return total;
+	}
+};
+
+/// @brief 向量区间内积
+/// @return x[b, e)·y[b, e)
+/// @param x 向量
+/// @param y 向量
+/// @param b 起点
+/// @param e 终点
+/// @tparam T 元素类型
+template <typename T>
+T solver_dot(std::vector<T> const& x, std::vector<T> const& y, size_t b, size_t e) noexcept
+{
+	T s = T();
+	for (auto k = b; k != e; ++k) {
+		s += x[k] * y[k];
+	}
+	return s;
+}
+
+/// @brief 共轭梯度法求解对称正定方程组 Ax = b
+/// @details 仅使用SpMV与向量运算，不会构造任何中间矩阵；整个迭代在一组常驻线程中按行划分进行，每次迭代同步三次
+/// @return 解与收敛信息，残差范数不超过 tol * |b| 时视为收敛
+/// @param a 对称正定系数矩阵
+/// @param b 右端向量
+/// @param tol 相对残差容限
+/// @param max_iter 最大迭代次数
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam T 元素类型
+/// @tparam N 矩阵阶数
+template <typename T, size_t N>
+solver_result<T> conjugate_gradient(csr_matrix<T, N, N> const& a, std::vector<T> const& b, T tol = T(1e-10), size_t max_iter = 1000, size_t threads = 1)
+{
+	static_assert(std::is_floating_point<T>::value, "Floating point type required");
+	if (b.size() != N) {
+		throw std::out_of_range("Vector size check failed");
+	}
+	auto res = solver_result<T>{ std::vector<T>(N), T(), 0, false };
+	auto& x = res.x;
+	auto r = b;
+	auto p = r;
+	auto ap = std::vector<T>(N);
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), N));
+	auto sum = solver_sum<T>(t);
+	parallel_team(t, [&](size_t i, parallel_barrier& sync) {
+		auto lo = N * i / t;
+		auto hi = N * (i + 1) / t;
+		auto rs = sum(i, solver_dot(r, r, lo, hi), sync);
+		auto limit = tol * std::sqrt(rs);
+		size_t iterations = 0;
+		bool converged;
+		while (!(converged = std::sqrt(rs) <= limit) && iterations != max_iter) {
+			a.spmv(p.data(), ap.data(), lo, hi);
+			auto alpha = rs / sum(i, solver_dot(p, ap, lo, hi), sync);
+			for (auto k = lo; k != hi; ++k) {
+				x[k] += alpha * p[k];
+				r[k] -= alpha * ap[k];
+			}
+			auto rs_new = sum(i, solver_dot(r, r, lo, hi), sync);
+			auto beta = rs_new / rs;
+			for (auto k = lo; k != hi; ++k) {
+				p[k] = r[k] + beta * p[k];
+			}
+			rs = rs_new;
+			++iterations;
+			sync.wait();
+		}
+		if (i == 0) {
+			res.iterations = iterations;
+			res.converged = converged;
+			res.value = std::sqrt(rs);
+		}
+	});
+	return res;
+}
+
+/// @brief 共轭梯度法求解对称正定方程组 Ax = b，矩阵仅压缩一次
+template <typename T, size_t N>
+solver_result<T> conjugate_gradient(sparse_matrix2d<T, N, N> const& a, std::vector<T> const& b, T tol = T(1e-10), size_t max_iter = 1000, size_t threads = 1)
+{
+	return conjugate_gradient(csr_matrix<T, N, N>(a), b, tol, max_iter, threads);
+}
+
+/// @brief 幂迭代求模最大特征值及其特征向量
+/// @details 每步仅做一次SpMV并归一化，可用于PageRank等迭代，不会构造矩阵乘积；整个迭代在一组常驻线程中按行划分进行
+/// @return 单位特征向量与特征值，相邻两步向量差的范数不超过tol时视为收敛
+/// @param a 方阵
+/// @param tol 收敛容限
+/// @param max_iter 最大迭代次数
+/// @param threads 线程数，为0时使用硬件并发数
+/// @tparam T 元素类型
+/// @tparam N 矩阵阶数
+template <typename T, size_t N>
+solver_result<T> power_iteration(csr_matrix<T, N, N> const& a, T tol = T(1e-10), size_t max_iter = 1000, size_t threads = 1)
+{
+	static_assert(std::is_floating_point<T>::value, "Floating point type required");
+	auto res = solver_result<T>{ std::vector<T>(N, T(1) / std::sqrt(T(N))), T(), 0, false };
+	auto& x = res.x;
+	auto y = std::vector<T>(N);
+	auto t = std::max<size_t>(1, std::min(parallel_threads(threads), N));
+	auto sum = solver_sum<T>(t);
+	parallel_team(t, [&](size_t i, parallel_barrier& sync) {
+		auto lo = N * i / t;
+		auto hi = N * (i + 1) / t;
+		auto value = T();
+		size_t iterations = 0;
+		auto converged = false;
+		while (!converged && iterations != max_iter) {
+			a.spmv(x.data(), y.data(), lo, hi);
+			value = sum(i, solver_dot(x, y, lo, hi), sync);
+			auto norm = std::sqrt(sum(i, solver_dot(y, y, lo, hi), sync));
+			if (norm == T()) {
+				break;
+			}
+			auto sign = value < T() ? -T(1) : T(1);
+			T d = T();
+			for (auto k = lo; k != hi; ++k) {
+				auto v = sign * y[k] / norm;
+				d += (v - x[k]) * (v - x[k]);
+				x[k] = v;
+			}
+			++iterations;
+			converged = std::sqrt(sum(i, d, sync)) <= tol;
+		}
+		if (i == 0) {
+			res.value = value;
+			res.iterations = iterations;
+			res.converged = converged;
+		}
+	});
+	return res;
+}
+
+/// @brief 幂迭代求模最大特征值及其特征向量，矩阵仅压缩一次
+template <typename T, size_t N>
+solver_result<T> power_iteration(sparse_matrix2d<T, N, N> const& a, T tol = T(1e-10), size_t max_iter = 1000, size_t threads = 1)
+{
+	return power_iteration(csr_matrix<T, N, N>(a), tol, max_iter, threads);
+}
+
+#define SparseSolver_defined
+
+#endif
+
+#endif